@@ -0,0 +1,110 @@
+//! Microbenchmarks for the hot network and feature-mapping kernels, so
+//! kernel-level optimisation work gets minute-scale feedback instead of
+//! full-engine A/B runs.
+//!
+//! Run with `cargo bench`. The corpus is the bench position set expanded by
+//! one ply (a few thousand positions); weight contents do not affect the
+//! timed work, so the layers are zero-allocated rather than loaded from a
+//! network file.
+
+use std::time::Instant;
+
+use monty::{
+    boxed_and_zeroed,
+    chess::ChessState,
+    networks::{policy::see, value::threats, Accumulator},
+    uci::BENCH_FENS,
+};
+
+const REPS: usize = 20;
+
+fn report<F: FnMut() -> u64>(name: &str, mut work: F) {
+    // discarded warmup pass
+    work();
+
+    let mut samples = Vec::with_capacity(REPS);
+
+    for _ in 0..REPS {
+        let timer = Instant::now();
+        let done = work();
+        samples.push(done as f64 / timer.elapsed().as_secs_f64());
+    }
+
+    let n = samples.len() as f64;
+    let mean = samples.iter().sum::<f64>() / n;
+    let var = samples.iter().map(|s| (s - mean) * (s - mean)).sum::<f64>() / n;
+    let ci = 1.96 * (var / n).sqrt();
+
+    println!("{name}: {mean:.0} +/- {ci:.0} ops/s ({REPS} reps)");
+}
+
+fn corpus() -> Vec<ChessState> {
+    let mut corpus = Vec::new();
+
+    for fen in BENCH_FENS {
+        let pos = ChessState::from_fen(fen);
+        corpus.push(pos.clone());
+
+        pos.map_legal_moves(|mov| {
+            let mut child = pos.clone();
+            child.make_move(mov);
+            corpus.push(child);
+        });
+    }
+
+    corpus
+}
+
+fn main() {
+    let corpus = corpus();
+    println!("corpus: {} positions", corpus.len());
+
+    report("threats::map_features (features)", || {
+        let mut count = 0u64;
+
+        for pos in &corpus {
+            let board = pos.board();
+            threats::map_features(board.bbs(), board.stm(), |_| count += 1);
+        }
+
+        count
+    });
+
+    {
+        const N: usize = 8192;
+        const ROWS: usize = 768;
+
+        let weights: Box<[Accumulator<i8, N>; ROWS]> = unsafe { boxed_and_zeroed() };
+        let mut acc: Box<Accumulator<i16, N>> = unsafe { boxed_and_zeroed() };
+        let adds: Vec<usize> = (0..ROWS).step_by(5).collect();
+
+        report("Accumulator::add_multi_i8 (rows)", || {
+            let mut count = 0u64;
+
+            for _ in 0..200 {
+                acc.add_multi_i8(&adds, &weights[..]);
+                count += adds.len() as u64;
+            }
+
+            std::hint::black_box(&acc);
+            count
+        });
+    }
+
+    report("see::greater_or_equal_to (moves)", || {
+        let mut count = 0u64;
+        let mut sink = 0u64;
+
+        for pos in &corpus {
+            let board = pos.board();
+
+            pos.map_legal_moves(|mov| {
+                sink += u64::from(see::greater_or_equal_to(&board, &mov, 0));
+                count += 1;
+            });
+        }
+
+        std::hint::black_box(sink);
+        count
+    });
+}
@@ -11,7 +11,9 @@ use monty::{
     chess::ChessState,
     mcts::MctsParams,
     networks::{self, PolicyNetwork, ValueNetwork},
-    read_into_struct_unchecked, uci, MappedWeights,
+    read_into_struct_unchecked,
+    tree::EvalCache,
+    uci, MappedWeights,
 };
 
 use std::{
@@ -20,6 +22,7 @@ use std::{
     io::{BufWriter, Write},
     sync::{
         atomic::{AtomicBool, Ordering},
+        mpsc::SyncSender,
         Arc, Mutex,
     },
     time::Duration,
@@ -61,7 +64,9 @@ pub fn to_slice_with_lifetime<T, U>(slice: &[T]) -> &[U] {
 }
 
 pub struct Destination {
-    writer: BufWriter<File>,
+    /// Completed game buffers are handed to the I/O thread over this
+    /// bounded channel, so game threads never stall on disk or on zstd.
+    writer: SyncSender<Vec<u8>>,
     reusable_buffer: Vec<u8>,
     games: usize,
     limit: usize,
@@ -90,7 +95,10 @@ impl Destination {
         self.searches += searches;
         self.iters += iters;
 
-        game.serialise_into(&mut self.writer).unwrap();
+        let mut buffer = std::mem::take(&mut self.reusable_buffer);
+        buffer.clear();
+        game.serialise_into(&mut buffer).unwrap();
+        self.writer.send(buffer).unwrap();
 
         if self.games >= self.limit {
             stop.store(true, Ordering::Relaxed);
@@ -120,10 +128,10 @@ impl Destination {
         self.searches += searches;
         self.iters += iters;
 
-        game.serialise_into_buffer(&mut self.reusable_buffer)
-            .unwrap();
-        self.writer.write_all(&self.reusable_buffer).unwrap();
-        self.reusable_buffer.clear();
+        let mut buffer = std::mem::take(&mut self.reusable_buffer);
+        buffer.clear();
+        game.serialise_into_buffer(&mut buffer).unwrap();
+        self.writer.send(buffer).unwrap();
 
         if self.games >= self.limit {
             stop.store(true, Ordering::Relaxed);
@@ -149,20 +157,53 @@ impl Destination {
 
 #[allow(clippy::too_many_arguments)]
 pub fn run_datagen(
-    params: MctsParams,
+    mut params: MctsParams,
     opts: RunOptions,
     policy: &PolicyNetwork,
     value: &ValueNetwork,
 ) {
     println!("{opts:#?}");
 
+    // collect several leaves per playout so the value net evaluates them
+    // back-to-back instead of as isolated single-position calls
+    params.set("batch_size", opts.batch as i32);
+
+    let eval_cache = Arc::new(EvalCache::new_mb(opts.threads * 16));
+
     let stop_base = AtomicBool::new(false);
     let stop = &stop_base;
 
-    let vout = File::create(opts.out_path.as_str()).unwrap();
-    let vout = BufWriter::new(vout);
+    let (tx, rx) = std::sync::mpsc::sync_channel::<Vec<u8>>(opts.threads.max(1) * 2);
+
+    let out_path = opts.out_path.clone();
+    let compress = !opts.raw_output;
+
+    // dedicated I/O thread: drains the channel, optionally compressing on
+    // the fly, and finishes the zstd frame when the last sender drops
+    let io_thread = std::thread::spawn(move || {
+        let file = BufWriter::new(File::create(out_path.as_str()).unwrap());
+
+        if compress {
+            let mut encoder = zstd::stream::write::Encoder::new(file, 3).unwrap();
+
+            for buffer in rx {
+                encoder.write_all(&buffer).unwrap();
+            }
+
+            encoder.finish().unwrap().flush().unwrap();
+        } else {
+            let mut writer = file;
+
+            for buffer in rx {
+                writer.write_all(&buffer).unwrap();
+            }
+
+            writer.flush().unwrap();
+        }
+    });
+
     let dest = Destination {
-        writer: vout,
+        writer: tx,
         reusable_buffer: Vec::new(),
         games: 0,
         searches: 0,
@@ -183,19 +224,23 @@ pub fn run_datagen(
             std::thread::sleep(Duration::from_millis(10));
             let this_book = book.clone();
             let this_dest = dest_mutex.clone();
+            let this_cache = eval_cache.clone();
             s.spawn(move || {
-                let mut thread = DatagenThread::new(params.clone(), stop, this_book, this_dest);
+                let mut thread =
+                    DatagenThread::new(params.clone(), stop, this_book, this_dest, this_cache);
                 thread.run(opts.policy_data, policy, value);
             });
         }
     });
 
-    let dest = dest_mutex.lock().unwrap();
+    dest_mutex.lock().unwrap().report();
 
-    dest.report();
+    // drop the last sender so the I/O thread sees end-of-stream
+    drop(dest_mutex);
+    io_thread.join().unwrap();
 }
 
-#[derive(Debug, Default)]
+#[derive(Debug)]
 pub struct RunOptions {
     games: usize,
     threads: usize,
@@ -203,6 +248,23 @@ pub struct RunOptions {
     policy_data: bool,
     nodes: usize,
     out_path: String,
+    batch: usize,
+    raw_output: bool,
+}
+
+impl Default for RunOptions {
+    fn default() -> Self {
+        Self {
+            games: 0,
+            threads: 0,
+            book: None,
+            policy_data: false,
+            nodes: 0,
+            out_path: String::new(),
+            batch: 8,
+            raw_output: false,
+        }
+    }
 }
 
 pub fn parse_args(args: Args) -> Option<RunOptions> {
@@ -223,6 +285,8 @@ pub fn parse_args(args: Args) -> Option<RunOptions> {
             "-n" | "--nodes" => mode = 3,
             "-o" | "--output" => mode = 4,
             "-g" | "--games" => mode = 5,
+            "--batch" => mode = 6,
+            "--raw-output" => opts.raw_output = true,
             _ => match mode {
                 1 => {
                     opts.threads = arg.parse().expect("can't parse");
@@ -244,6 +308,10 @@ pub fn parse_args(args: Args) -> Option<RunOptions> {
                     opts.games = arg.parse().expect("can't parse");
                     mode = 0;
                 }
+                6 => {
+                    opts.batch = arg.parse().expect("can't parse");
+                    mode = 0;
+                }
                 _ => println!("unrecognised argument {arg}"),
             },
         }
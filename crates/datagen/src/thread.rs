@@ -7,7 +7,7 @@ use monty::{
     chess::{ChessState, GameState},
     mcts::{Limits, MctsParams, Searcher},
     networks::{PolicyNetwork, ValueNetwork},
-    tree::Tree,
+    tree::{EvalCache, Tree},
 };
 use montyformat::{MontyFormat, MontyValueFormat, SearchData};
 
@@ -22,6 +22,7 @@ pub struct DatagenThread<'a> {
     dest: Arc<Mutex<Destination>>,
     stop: &'a AtomicBool,
     book: Option<OpeningBookReader>,
+    eval_cache: Arc<EvalCache>,
 }
 
 impl<'a> DatagenThread<'a> {
@@ -30,6 +31,7 @@ impl<'a> DatagenThread<'a> {
         stop: &'a AtomicBool,
         book: Option<OpeningBook>,
         dest: Arc<Mutex<Destination>>,
+        eval_cache: Arc<EvalCache>,
     ) -> Self {
         let book = book.map(|book| book.reader().expect("failed to open opening book reader"));
 
@@ -39,6 +41,7 @@ impl<'a> DatagenThread<'a> {
             dest,
             stop,
             book,
+            eval_cache,
         }
     }
 
@@ -79,7 +82,14 @@ impl<'a> DatagenThread<'a> {
 
         let mut result = 0.5;
 
-        let mut tree = Tree::new_mb(8, 1);
+        // no private eval cache (the shared one is injected below) and a
+        // small policy cache: the defaults would allocate 48 MB of caches
+        // per game against an 8 MB tree
+        let mut tree = Tree::new_mb_with_caches(8, 1, 0, 2);
+        // share the inference cache across all game threads: openings and
+        // early-middlegame positions repeat heavily between games, so their
+        // evals come from the cache instead of the 8192-wide matmul
+        tree.use_shared_eval_cache(self.eval_cache.clone());
         let mut temp = 0.8;
 
         let startpos = position.board();
@@ -0,0 +1,54 @@
+use std::{env, io};
+
+use montyformat::{MontyFormat, MontyValueFormat};
+
+fn usage_error(msg: &str) -> io::Error {
+    io::Error::new(
+        io::ErrorKind::InvalidInput,
+        format!(
+            "{msg}\nusage: interleave <policy|value> <output> <seed> <input> [<input>...] [--buffered]"
+        ),
+    )
+}
+
+fn main() -> io::Result<()> {
+    let mut args = env::args().skip(1);
+
+    let format_kind = args
+        .next()
+        .ok_or_else(|| usage_error("Missing format kind (policy/value)"))?;
+
+    let output_path = args
+        .next()
+        .ok_or_else(|| usage_error("Missing output path"))?;
+
+    let seed: u64 = args
+        .next()
+        .and_then(|s| s.parse().ok())
+        .ok_or_else(|| usage_error("Missing or invalid seed"))?;
+
+    let mut buffered = false;
+    let mut input_paths = Vec::new();
+
+    for arg in args {
+        if arg == "--buffered" {
+            buffered = true;
+        } else {
+            input_paths.push(arg);
+        }
+    }
+
+    if input_paths.is_empty() {
+        return Err(usage_error("Missing input paths"));
+    }
+
+    // the mmap-indexed shuffle is the default: constant memory regardless of
+    // input sizes; --buffered keeps the old remaining-bytes streaming mode
+    match (format_kind.as_str(), buffered) {
+        ("policy", false) => MontyFormat::interleave_mmap(&input_paths, &output_path, seed),
+        ("policy", true) => MontyFormat::interleave(&input_paths, &output_path, seed),
+        ("value", false) => MontyValueFormat::interleave_mmap(&input_paths, &output_path, seed),
+        ("value", true) => MontyValueFormat::interleave(&input_paths, &output_path, seed),
+        _ => Err(usage_error("Format kind must be 'policy' or 'value'")),
+    }
+}
@@ -30,10 +30,30 @@ impl Attacks {
         LOOKUP.king[sq]
     }
 
+    #[inline]
+    pub fn bishop(sq: usize, occ: u64) -> u64 {
+        #[cfg(target_arch = "x86_64")]
+        if let Some(tables) = pext::TABLES.as_ref() {
+            return unsafe { tables.bishop(sq, occ) };
+        }
+
+        Self::bishop_classic(sq, occ)
+    }
+
+    #[inline]
+    pub fn rook(sq: usize, occ: u64) -> u64 {
+        #[cfg(target_arch = "x86_64")]
+        if let Some(tables) = pext::TABLES.as_ref() {
+            return unsafe { tables.rook(sq, occ) };
+        }
+
+        Self::rook_classic(sq, occ)
+    }
+
     // hyperbola quintessence
     // this gets automatically vectorised when targeting avx or better
     #[inline]
-    pub fn bishop(sq: usize, occ: u64) -> u64 {
+    fn bishop_classic(sq: usize, occ: u64) -> u64 {
         let mask = LOOKUP.bishop[sq];
 
         let mut diag = occ & mask.diag;
@@ -56,7 +76,7 @@ impl Attacks {
     // shifted lookup
     // files and ranks are mapped to 1st rank and looked up by occupancy
     #[inline]
-    pub fn rook(sq: usize, occ: u64) -> u64 {
+    fn rook_classic(sq: usize, occ: u64) -> u64 {
         let flip = ((occ >> (sq & 7)) & File::A).wrapping_mul(DIAG);
         let file_sq = (flip >> 57) & 0x3F;
         let files = LOOKUP.file[sq][file_sq as usize];
@@ -221,3 +241,133 @@ pub const fn line_through(i: usize, j: usize) -> u64 {
 
     0
 }
+
+/// PEXT-indexed flat attack tables, selected once at runtime. Kept off on
+/// pre-Zen3 AMD parts, where PEXT is microcoded and slower than the
+/// arithmetic schemes above.
+#[cfg(target_arch = "x86_64")]
+mod pext {
+    use std::sync::LazyLock;
+
+    use super::{Attacks, File};
+
+    pub struct PextTables {
+        rook_mask: [u64; 64],
+        rook_offset: [u32; 64],
+        bishop_mask: [u64; 64],
+        bishop_offset: [u32; 64],
+        table: Vec<u64>,
+    }
+
+    pub static TABLES: LazyLock<Option<PextTables>> = LazyLock::new(|| {
+        if !is_x86_feature_detected!("bmi2") || slow_pext() {
+            return None;
+        }
+
+        Some(PextTables::build())
+    });
+
+    /// PEXT is microcoded (dozens of cycles) on AMD families before Zen 3.
+    fn slow_pext() -> bool {
+        use core::arch::x86_64::__cpuid;
+
+        let leaf0 = unsafe { __cpuid(0) };
+        let amd = (leaf0.ebx, leaf0.edx, leaf0.ecx) == (0x6874_7541, 0x6974_6e65, 0x444d_4163);
+
+        if !amd {
+            return false;
+        }
+
+        let leaf1 = unsafe { __cpuid(1) };
+        let base_family = (leaf1.eax >> 8) & 0xF;
+        let ext_family = (leaf1.eax >> 20) & 0xFF;
+        let family = base_family + if base_family == 0xF { ext_family } else { 0 };
+
+        // Zen 3 is family 0x19; everything older microcodes PEXT
+        family < 0x19
+    }
+
+    fn edge_stripped_rook_mask(sq: usize) -> u64 {
+        let rank = 0xFFu64 << (sq & 56);
+        let file = File::A << (sq & 7);
+
+        let horizontal = rank & !(File::A | File::H);
+        let vertical = file & !(0xFF | (0xFFu64 << 56));
+
+        (horizontal | vertical) & !(1u64 << sq)
+    }
+
+    fn edge_stripped_bishop_mask(sq: usize) -> u64 {
+        let attacks = Attacks::bishop_classic(sq, 0);
+        attacks & !(0xFF | (0xFFu64 << 56) | File::A | File::H)
+    }
+
+    impl PextTables {
+        fn build() -> Self {
+            let mut tables = PextTables {
+                rook_mask: [0; 64],
+                rook_offset: [0; 64],
+                bishop_mask: [0; 64],
+                bishop_offset: [0; 64],
+                table: Vec::new(),
+            };
+
+            for sq in 0..64 {
+                let mask = edge_stripped_rook_mask(sq);
+                tables.rook_mask[sq] = mask;
+                tables.rook_offset[sq] = tables.table.len() as u32;
+
+                // carry-rippler over all subsets of the mask, in the same
+                // order PEXT extracts them
+                // the classic scheme fills the table; calling the public
+                // dispatchers here would re-enter the LazyLock initialiser
+                let mut occ = 0u64;
+                loop {
+                    tables.table.push(Attacks::rook_classic(sq, occ));
+                    occ = occ.wrapping_sub(mask) & mask;
+                    if occ == 0 {
+                        break;
+                    }
+                }
+            }
+
+            for sq in 0..64 {
+                let mask = edge_stripped_bishop_mask(sq);
+                tables.bishop_mask[sq] = mask;
+                tables.bishop_offset[sq] = tables.table.len() as u32;
+
+                let mut occ = 0u64;
+                loop {
+                    tables.table.push(Attacks::bishop_classic(sq, occ));
+                    occ = occ.wrapping_sub(mask) & mask;
+                    if occ == 0 {
+                        break;
+                    }
+                }
+            }
+
+            tables
+        }
+
+        /// # Safety
+        /// Requires BMI2; `TABLES` is only populated when it is detected.
+        #[target_feature(enable = "bmi2")]
+        pub unsafe fn rook(&self, sq: usize, occ: u64) -> u64 {
+            use core::arch::x86_64::_pext_u64;
+
+            let idx = self.rook_offset[sq] as usize + _pext_u64(occ, self.rook_mask[sq]) as usize;
+            self.table[idx]
+        }
+
+        /// # Safety
+        /// Requires BMI2; `TABLES` is only populated when it is detected.
+        #[target_feature(enable = "bmi2")]
+        pub unsafe fn bishop(&self, sq: usize, occ: u64) -> u64 {
+            use core::arch::x86_64::_pext_u64;
+
+            let idx =
+                self.bishop_offset[sq] as usize + _pext_u64(occ, self.bishop_mask[sq]) as usize;
+            self.table[idx]
+        }
+    }
+}
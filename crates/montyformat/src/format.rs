@@ -2,7 +2,7 @@ use std::io::{Error, ErrorKind, Write};
 
 use crate::{
     chess::{Castling, Move, Position},
-    interleave::{interleave, FastDeserialise},
+    interleave::{interleave, interleave_mmap, FastDeserialise},
     read_into_primitive,
 };
 
@@ -218,6 +218,15 @@ impl MontyFormat {
     pub fn interleave(input_paths: &[String], output_path: &str, seed: u64) -> std::io::Result<()> {
         interleave::<Self>(input_paths, output_path, seed)
     }
+
+    /// Constant-memory variant; see [`interleave_mmap`].
+    pub fn interleave_mmap(
+        input_paths: &[String],
+        output_path: &str,
+        seed: u64,
+    ) -> std::io::Result<()> {
+        interleave_mmap::<Self>(input_paths, output_path, seed)
+    }
 }
 
 impl FastDeserialise for MontyFormat {
@@ -1,6 +1,6 @@
 use std::{
     fs::File,
-    io::{BufReader, BufWriter, Write},
+    io::{BufRead, BufReader, BufWriter, Write},
 };
 
 struct RandU64(u64);
@@ -21,6 +21,98 @@ pub trait FastDeserialise {
     ) -> std::io::Result<()>;
 }
 
+/// Constant-memory interleave: mmap each input, index the game offsets in
+/// one sequential pass per file (parallelised across inputs), then stream
+/// the games in a seeded Fisher-Yates order straight from page cache to the
+/// output writer. Memory use is one index entry per game rather than any
+/// function of the input sizes.
+pub fn interleave_mmap<T: FastDeserialise>(
+    input_paths: &[String],
+    output_path: &str,
+    seed: u64,
+) -> std::io::Result<()> {
+    use rayon::prelude::*;
+    use std::sync::Arc;
+
+    println!("Writing to {:#?}", output_path);
+    println!("Reading from:\n{:#?}", input_paths);
+
+    let mut maps = Vec::new();
+
+    for path in input_paths {
+        let file = File::open(path)?;
+
+        if file.metadata()?.len() == 0 {
+            continue;
+        }
+
+        maps.push(Arc::new(unsafe { memmap2::Mmap::map(&file)? }));
+    }
+
+    // one (file, offset, len) entry per game
+    let mut index: Vec<(u32, u64, u32)> = maps
+        .par_iter()
+        .enumerate()
+        .map(|(file_idx, map)| {
+            let mut entries = Vec::new();
+            let mut cursor = std::io::Cursor::new(&map[..]);
+            let mut buffer = Vec::new();
+
+            loop {
+                let offset = cursor.position();
+
+                if offset as usize >= map.len() {
+                    break;
+                }
+
+                if T::deserialise_fast_into_buffer(&mut cursor, &mut buffer).is_err() {
+                    break;
+                }
+
+                entries.push((
+                    file_idx as u32,
+                    offset,
+                    (cursor.position() - offset) as u32,
+                ));
+            }
+
+            entries
+        })
+        .reduce(Vec::new, |mut acc, mut chunk| {
+            acc.append(&mut chunk);
+            acc
+        });
+
+    let total = index.len();
+    println!("indexed {total} games");
+
+    // seeded Fisher-Yates over the index
+    let mut rng = RandU64(seed);
+
+    for i in (1..index.len()).rev() {
+        let j = (rng.rand() % (i as u64 + 1)) as usize;
+        index.swap(i, j);
+    }
+
+    let target = File::create(output_path)?;
+    let mut writer = BufWriter::new(target);
+
+    for (done, &(file_idx, offset, len)) in index.iter().enumerate() {
+        let map = &maps[file_idx as usize];
+        writer.write_all(&map[offset as usize..offset as usize + len as usize])?;
+
+        if done % (1 << 20) == 0 {
+            print!("Written {done}/{total} games\r");
+            let _ = std::io::stdout().flush();
+        }
+    }
+
+    writer.flush()?;
+    println!("Written {total}/{total} games");
+
+    Ok(())
+}
+
 pub fn interleave<T: FastDeserialise>(
     input_paths: &[String],
     output_path: &str,
@@ -40,7 +132,19 @@ pub fn interleave<T: FastDeserialise>(
         let count = file.metadata()?.len();
 
         if count > 0 {
-            streams.push((count, BufReader::new(file)));
+            let mut reader = BufReader::new(file);
+
+            // the byte accounting below needs raw sizes, so compressed
+            // binpacks must be decompressed before interleaving
+            let head = reader.fill_buf()?;
+            if head.len() >= 4 && head[..4] == crate::ZSTD_MAGIC {
+                return Err(std::io::Error::new(
+                    std::io::ErrorKind::InvalidData,
+                    format!("{path} is zstd-compressed; decompress before interleaving"),
+                ));
+            }
+
+            streams.push((count, reader));
             total += count;
         }
     }
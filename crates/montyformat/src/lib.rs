@@ -7,6 +7,32 @@ pub use format::{MontyFormat, SearchData};
 pub use interleave::FastDeserialise;
 pub use value::{MontyValueFormat, SearchResult};
 
+/// Magic bytes of a zstd frame, used to sniff compressed binpacks.
+pub const ZSTD_MAGIC: [u8; 4] = [0x28, 0xB5, 0x2F, 0xFD];
+
+/// Open a binpack for reading, transparently decompressing zstd-compressed
+/// files (as written by datagen) so downstream tools consume either form
+/// through the same `BufRead`.
+pub fn open_binpack(path: &str) -> std::io::Result<Box<dyn std::io::BufRead + Send>> {
+    use std::io::{BufReader, Read, Seek, SeekFrom};
+
+    let mut file = std::fs::File::open(path)?;
+
+    let mut magic = [0u8; 4];
+    let compressed = match file.read_exact(&mut magic) {
+        Ok(()) => magic == ZSTD_MAGIC,
+        Err(_) => false,
+    };
+    file.seek(SeekFrom::Start(0))?;
+
+    if compressed {
+        let decoder = zstd::stream::read::Decoder::new(file)?;
+        Ok(Box::new(BufReader::new(decoder)))
+    } else {
+        Ok(Box::new(BufReader::new(file)))
+    }
+}
+
 macro_rules! init {
     (|$sq:ident, $size:literal | $($rest:tt)+) => {{
         let mut $sq = 0;
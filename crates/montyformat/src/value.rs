@@ -1,7 +1,7 @@
 use crate::{
     chess::{Castling, Move, Position},
     format::CompressedChessBoard,
-    interleave::{interleave, FastDeserialise},
+    interleave::{interleave, interleave_mmap, FastDeserialise},
     read_into_primitive, read_primitive_into_vec,
 };
 
@@ -127,6 +127,15 @@ impl MontyValueFormat {
     pub fn interleave(input_paths: &[String], output_path: &str, seed: u64) -> std::io::Result<()> {
         interleave::<Self>(input_paths, output_path, seed)
     }
+
+    /// Constant-memory variant; see [`interleave_mmap`].
+    pub fn interleave_mmap(
+        input_paths: &[String],
+        output_path: &str,
+        seed: u64,
+    ) -> std::io::Result<()> {
+        interleave_mmap::<Self>(input_paths, output_path, seed)
+    }
 }
 
 impl FastDeserialise for MontyValueFormat {
@@ -1,7 +1,9 @@
 use std::{
-    fs::File,
-    io::{BufReader, Cursor},
-    sync::mpsc::{self, SyncSender},
+    io::Cursor,
+    sync::{
+        atomic::{AtomicBool, Ordering},
+        mpsc, Arc, Mutex,
+    },
     time::{SystemTime, UNIX_EPOCH},
 };
 
@@ -53,24 +55,27 @@ where
     }
 
     fn map_batches<F: FnMut(&[ChessBoard]) -> bool>(&self, _: usize, batch_size: usize, mut f: F) {
-        let mut shuffle_buffer = Vec::new();
-        shuffle_buffer.reserve_exact(self.buffer_size);
+        // pipeline: one reader thread streams raw game buffers, N decode
+        // workers pull from a shared channel and parse/filter continuously,
+        // a shuffle thread fills buffers, and the buffer channel holds one
+        // spare so the next buffer is built while the current one drains
+        let stop = Arc::new(AtomicBool::new(false));
 
         let file_paths = self.file_paths.clone();
         let buffer_size = self.buffer_size;
 
-        let (sender, receiver) = mpsc::sync_channel::<Vec<u8>>(256);
-        let (msg_sender, msg_receiver) = mpsc::sync_channel::<bool>(1);
+        let (raw_sender, raw_receiver) = mpsc::sync_channel::<Vec<u8>>(256);
 
+        let reader_stop = stop.clone();
         std::thread::spawn(move || 'dataloading: loop {
             for file_path in &file_paths {
-                let mut reader = BufReader::new(File::open(file_path.as_str()).unwrap());
+                let mut reader = montyformat::open_binpack(file_path.as_str()).unwrap();
 
                 let mut buffer = Vec::new();
                 while let Ok(()) =
                     MontyValueFormat::deserialise_fast_into_buffer(&mut reader, &mut buffer)
                 {
-                    if msg_receiver.try_recv().unwrap_or(false) || sender.send(buffer).is_err() {
+                    if reader_stop.load(Ordering::Relaxed) || raw_sender.send(buffer).is_err() {
                         break 'dataloading;
                     }
 
@@ -79,37 +84,59 @@ where
             }
         });
 
+        const WORKER_FLUSH: usize = 16384;
+
         let (game_sender, game_receiver) = mpsc::sync_channel::<Vec<ChessBoard>>(4 * self.threads);
-        let (game_msg_sender, game_msg_receiver) = mpsc::sync_channel::<bool>(1);
+        let raw_receiver = Arc::new(Mutex::new(raw_receiver));
 
-        let threads = self.threads;
-        let filter = self.filter.clone();
+        for _ in 0..self.threads {
+            let raw_receiver = raw_receiver.clone();
+            let game_sender = game_sender.clone();
+            let filter = self.filter.clone();
+            let worker_stop = stop.clone();
 
-        std::thread::spawn(move || {
-            let mut reusable = Vec::new();
-            'dataloading: while let Ok(game_bytes) = receiver.recv() {
-                if game_msg_receiver.try_recv().unwrap_or(false) {
-                    msg_sender.send(true).unwrap();
-                    break 'dataloading;
-                }
+            std::thread::spawn(move || {
+                let mut buffer = Vec::with_capacity(WORKER_FLUSH);
+
+                loop {
+                    let game_bytes = {
+                        let lock = raw_receiver.lock().unwrap();
+                        lock.recv()
+                    };
+
+                    let Ok(game_bytes) = game_bytes else { break };
+
+                    if worker_stop.load(Ordering::Relaxed) {
+                        break;
+                    }
 
-                reusable.push(game_bytes);
+                    parse_into_buffer(&game_bytes, &mut buffer, &filter);
 
-                if reusable.len() % (8192 * threads) == 0 {
-                    convert_buffer(threads, &game_sender, &reusable, &filter);
-                    reusable.clear();
+                    if buffer.len() >= WORKER_FLUSH {
+                        let full = std::mem::replace(&mut buffer, Vec::with_capacity(WORKER_FLUSH));
+
+                        if game_sender.send(full).is_err() {
+                            break;
+                        }
+                    }
                 }
-            }
-        });
+            });
+        }
+
+        // drop the clone retained by this thread so the channel closes once
+        // every worker exits
+        drop(game_sender);
 
-        let (buffer_sender, buffer_receiver) = mpsc::sync_channel::<Vec<ChessBoard>>(0);
-        let (buffer_msg_sender, buffer_msg_receiver) = mpsc::sync_channel::<bool>(1);
+        let (buffer_sender, buffer_receiver) = mpsc::sync_channel::<Vec<ChessBoard>>(1);
 
+        let shuffle_stop = stop.clone();
         std::thread::spawn(move || {
-            'dataloading: while let Ok(game) = game_receiver.recv() {
-                if buffer_msg_receiver.try_recv().unwrap_or(false) {
-                    game_msg_sender.send(true).unwrap();
-                    break 'dataloading;
+            let mut shuffle_buffer = Vec::new();
+            shuffle_buffer.reserve_exact(buffer_size);
+
+            while let Ok(game) = game_receiver.recv() {
+                if shuffle_stop.load(Ordering::Relaxed) {
+                    break;
                 }
 
                 if shuffle_buffer.len() + game.len() < shuffle_buffer.capacity() {
@@ -122,11 +149,8 @@ where
 
                     shuffle(&mut shuffle_buffer);
 
-                    if buffer_msg_receiver.try_recv().unwrap_or(false)
-                        || buffer_sender.send(shuffle_buffer).is_err()
-                    {
-                        game_msg_sender.send(true).unwrap();
-                        break 'dataloading;
+                    if buffer_sender.send(shuffle_buffer).is_err() {
+                        return;
                     }
 
                     shuffle_buffer = Vec::new();
@@ -141,40 +165,18 @@ where
                 let should_break = f(batch);
 
                 if should_break {
-                    buffer_msg_sender.send(true).unwrap();
+                    stop.store(true, Ordering::Relaxed);
                     break 'dataloading;
                 }
             }
         }
 
+        // dropping the receivers unblocks any thread parked on a full
+        // channel; the stop flag catches the rest
         drop(buffer_receiver);
     }
 }
 
-fn convert_buffer<T: Fn(&Position, Move, i16, f32) -> bool + Send + Sync>(
-    threads: usize,
-    sender: &SyncSender<Vec<ChessBoard>>,
-    games: &[Vec<u8>],
-    filter: &T,
-) {
-    let chunk_size = games.len().div_ceil(threads);
-
-    std::thread::scope(|s| {
-        for chunk in games.chunks(chunk_size) {
-            let this_sender = sender.clone();
-            s.spawn(move || {
-                let mut buffer = Vec::new();
-
-                for game_bytes in chunk {
-                    parse_into_buffer(game_bytes, &mut buffer, filter);
-                }
-
-                this_sender.send(buffer)
-            });
-        }
-    });
-}
-
 fn parse_into_buffer<T: Fn(&Position, Move, i16, f32) -> bool>(
     game_bytes: &[u8],
     buffer: &mut Vec<ChessBoard>,
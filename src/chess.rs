@@ -1,6 +1,6 @@
 use crate::{
     mcts::MctsParams,
-    networks::{Accumulator, PolicyNetwork, ValueNetwork, POLICY_L1},
+    networks::{Accumulator, IncrementalState, PolicyNetwork, ValueNetwork, POLICY_L1},
 };
 
 pub use montyformat::chess::{Attacks, Castling, GameState, Move, Position};
@@ -140,6 +140,14 @@ impl ChessState {
         mov.to_uci(&self.castling)
     }
 
+    pub fn from_raw(board: Position, castling: Castling) -> Self {
+        Self {
+            board,
+            castling,
+            stack: Vec::new(),
+        }
+    }
+
     pub fn from_fen(fen: &str) -> Self {
         let mut castling = Castling::default();
         let board = Position::parse_fen(fen, &mut castling);
@@ -179,10 +187,20 @@ impl ChessState {
     pub fn map_moves_with_policies<F: FnMut(Move, f32)>(&self, policy: &PolicyNetwork, mut f: F) {
         let hl = policy.hl(&self.board);
 
+        let mut moves = [Move::default(); 256];
+        let mut count = 0;
+
         self.map_legal_moves(|mov| {
-            let policy = policy.get(&self.board, &mov, &hl);
-            f(mov, policy);
+            moves[count] = mov;
+            count += 1;
         });
+
+        let mut scores = [0.0; 256];
+        policy.get_all(&self.board, &moves[..count], &hl, &mut scores[..count]);
+
+        for (&mov, &score) in moves[..count].iter().zip(scores[..count].iter()) {
+            f(mov, score);
+        }
     }
 
     pub fn get_policy_hl(&self, policy: &PolicyNetwork) -> Accumulator<i16, { POLICY_L1 / 2 }> {
@@ -198,12 +216,41 @@ impl ChessState {
         policy.get(&self.board, &mov, hl)
     }
 
+    pub fn get_policies(
+        &self,
+        policy: &PolicyNetwork,
+        moves: &[Move],
+        hl: &Accumulator<i16, { POLICY_L1 / 2 }>,
+        scores: &mut [f32],
+    ) {
+        policy.get_all(&self.board, moves, hl, scores);
+    }
+
+    pub fn raw_eval(&self, value: &ValueNetwork) -> (f32, f32, f32) {
+        value.eval(&self.board)
+    }
+
+    pub fn raw_eval_with_state(
+        &self,
+        value: &ValueNetwork,
+        state: &mut IncrementalState,
+    ) -> (f32, f32, f32) {
+        value.eval_with_state(&self.board, state)
+    }
+
     fn evaluate_material_wdl(
         &self,
         value: &ValueNetwork,
         params: &MctsParams,
     ) -> (EvalWdl, EvalWdl, i32) {
-        let (win, draw, loss) = value.eval(&self.board);
+        self.material_wdl_from_raw(self.raw_eval(value), params)
+    }
+
+    fn material_wdl_from_raw(
+        &self,
+        (win, draw, loss): (f32, f32, f32),
+        params: &MctsParams,
+    ) -> (EvalWdl, EvalWdl, i32) {
         let raw = EvalWdl::new(win, draw, loss);
 
         #[cfg(not(feature = "datagen"))]
@@ -238,7 +285,16 @@ impl ChessState {
         params: &MctsParams,
         root_stm: usize,
     ) -> EvalBreakdown {
-        let (raw, material, cp) = self.evaluate_material_wdl(value, params);
+        self.eval_with_contempt_from_raw(self.raw_eval(value), params, root_stm)
+    }
+
+    pub fn eval_with_contempt_from_raw(
+        &self,
+        raw_eval: (f32, f32, f32),
+        params: &MctsParams,
+        root_stm: usize,
+    ) -> EvalBreakdown {
+        let (raw, material, cp) = self.material_wdl_from_raw(raw_eval, params);
         let contempt = params.contempt() as f32;
         let perspective = if self.stm() == root_stm { 1.0 } else { -1.0 };
         let contempt_scaled = material.apply_contempt(contempt * perspective);
@@ -266,6 +322,46 @@ impl ChessState {
         perft::<true, true>(&self.board, depth as u8, &self.castling)
     }
 
+    /// Hash-accelerated perft with the root move list split across a thread
+    /// pool; counts are bulk at the leaves as in the plain version.
+    pub fn perft_parallel(&self, depth: usize, threads: usize, table_mb: usize) -> u64 {
+        if depth <= 2 || threads <= 1 {
+            return self.perft(depth);
+        }
+
+        let table = PerftTable::new_mb(table_mb);
+
+        let mut root_moves = Vec::new();
+        self.map_legal_moves(|mov| root_moves.push(mov));
+
+        let next = std::sync::atomic::AtomicUsize::new(0);
+        let total = std::sync::atomic::AtomicU64::new(0);
+
+        std::thread::scope(|s| {
+            for _ in 0..threads.min(root_moves.len()) {
+                s.spawn(|| {
+                    let mut local = 0;
+
+                    loop {
+                        let idx = next.fetch_add(1, std::sync::atomic::Ordering::Relaxed);
+
+                        if idx >= root_moves.len() {
+                            break;
+                        }
+
+                        let mut child = self.board;
+                        child.make(root_moves[idx], &self.castling);
+                        local += perft_hashed(&child, depth as u8 - 1, &self.castling, &table);
+                    }
+
+                    total.fetch_add(local, std::sync::atomic::Ordering::Relaxed);
+                });
+            }
+        });
+
+        total.load(std::sync::atomic::Ordering::Relaxed)
+    }
+
     pub fn display(&self, policy: &PolicyNetwork) {
         let mut moves = Vec::new();
         let mut max = f32::NEG_INFINITY;
@@ -338,6 +434,78 @@ impl ChessState {
     }
 }
 
+/// Lock-free always-replace perft table keyed by (hash, depth), using the
+/// usual key-xor-data scheme so torn entries fail validation instead of
+/// returning a wrong count.
+struct PerftTable {
+    entries: Vec<(std::sync::atomic::AtomicU64, std::sync::atomic::AtomicU64)>,
+}
+
+impl PerftTable {
+    fn new_mb(mb: usize) -> Self {
+        let len = mb.max(1) * 1024 * 1024 / 16;
+        let mut entries = Vec::with_capacity(len);
+        entries.resize_with(len, Default::default);
+        Self { entries }
+    }
+
+    fn key(pos: &Position, depth: u8) -> u64 {
+        // mix the depth into the position hash so (hash, depth) pairs
+        // occupy distinct slots
+        pos.hash() ^ (u64::from(depth)).wrapping_mul(0x9e3779b97f4a7c15)
+    }
+
+    fn get(&self, pos: &Position, depth: u8) -> Option<u64> {
+        use std::sync::atomic::Ordering::Relaxed;
+
+        let key = Self::key(pos, depth);
+        let entry = &self.entries[(key % self.entries.len() as u64) as usize];
+
+        let stored = entry.0.load(Relaxed);
+        let count = entry.1.load(Relaxed);
+
+        if stored ^ count == key && stored != 0 {
+            Some(count)
+        } else {
+            None
+        }
+    }
+
+    fn push(&self, pos: &Position, depth: u8, count: u64) {
+        use std::sync::atomic::Ordering::Relaxed;
+
+        let key = Self::key(pos, depth);
+        let entry = &self.entries[(key % self.entries.len() as u64) as usize];
+
+        entry.0.store(key ^ count, Relaxed);
+        entry.1.store(count, Relaxed);
+    }
+}
+
+fn perft_hashed(pos: &Position, depth: u8, castling: &Castling, table: &PerftTable) -> u64 {
+    if depth == 1 {
+        let mut count = 0;
+        pos.map_legal_moves(castling, |_| count += 1);
+        return count;
+    }
+
+    if let Some(count) = table.get(pos, depth) {
+        return count;
+    }
+
+    let mut count = 0;
+
+    pos.map_legal_moves(castling, |mov| {
+        let mut tmp = *pos;
+        tmp.make(mov, castling);
+        count += perft_hashed(&tmp, depth - 1, castling, table);
+    });
+
+    table.push(pos, depth, count);
+
+    count
+}
+
 fn perft<const ROOT: bool, const BULK: bool>(
     pos: &Position,
     depth: u8,
@@ -0,0 +1,235 @@
+//! Root-parallel search across machines.
+//!
+//! Worker instances (`monty worker <bind-addr> [threads]`) serve searches
+//! over a line-based TCP protocol; a coordinator drives them with the
+//! `distgo <movetime> <addr> [<addr>...]` UCI command, searching the same
+//! root locally while the workers run, then merging their root-child
+//! visit/q/draw totals into its own root distribution (the same
+//! `NodeStatsDelta` aggregation the threads use in-process) before making
+//! the final move choice.
+
+use std::{
+    io::{BufRead, BufReader, Write},
+    net::{TcpListener, TcpStream},
+    sync::atomic::AtomicBool,
+};
+
+use crate::{
+    chess::ChessState,
+    mcts::{Limits, MctsParams, Searcher},
+    networks::{PolicyNetwork, ValueNetwork},
+    tree::Tree,
+};
+
+/// One reported root child: uci move, visits, q, draw rate.
+type RootStat = (String, u64, f32, f32);
+
+fn search_limits(movetime: u128) -> Limits {
+    Limits {
+        max_time: Some(movetime),
+        opt_time: None,
+        max_depth: 256,
+        max_nodes: usize::MAX,
+        #[cfg(feature = "datagen")]
+        kld_min_gain: None,
+    }
+}
+
+/// Serve searches to a coordinator. The tree persists between requests, so
+/// consecutive positions on the same line reuse subtrees as usual.
+pub fn run_worker(addr: &str, threads: usize, policy: &PolicyNetwork, value: &ValueNetwork) {
+    let listener = TcpListener::bind(addr).expect("failed to bind worker address");
+    println!("info string worker listening on {addr}");
+
+    let params = MctsParams::default();
+    let mut tree = Tree::new_mb(64, threads);
+
+    for stream in listener.incoming() {
+        let Ok(stream) = stream else { continue };
+
+        if let Err(e) = serve(stream, &mut tree, &params, policy, value, threads) {
+            println!("info string worker connection closed: {e}");
+        }
+    }
+}
+
+fn serve(
+    stream: TcpStream,
+    tree: &mut Tree,
+    params: &MctsParams,
+    policy: &PolicyNetwork,
+    value: &ValueNetwork,
+    threads: usize,
+) -> std::io::Result<()> {
+    let mut writer = stream.try_clone()?;
+    let reader = BufReader::new(stream);
+
+    for line in reader.lines() {
+        let line = line?;
+        let mut parts = line.splitn(3, ' ');
+
+        match parts.next() {
+            Some("search") => {
+                let movetime: u128 = parts
+                    .next()
+                    .and_then(|v| v.parse().ok())
+                    .unwrap_or(1000);
+                let Some(fen) = parts.next() else { continue };
+
+                let pos = ChessState::from_fen(fen);
+                tree.set_root_position(&pos);
+
+                let abort = AtomicBool::new(false);
+                let searcher = Searcher::new(tree, params, policy, value, &abort);
+
+                #[cfg(not(feature = "datagen"))]
+                searcher.search(threads, search_limits(movetime), false, 1, false, &mut 0);
+                #[cfg(feature = "datagen")]
+                searcher.search(
+                    threads,
+                    search_limits(movetime),
+                    false,
+                    1,
+                    false,
+                    &mut 0,
+                    false,
+                    1.0,
+                );
+
+                let stats = tree.root_child_stats();
+
+                writeln!(writer, "root {}", stats.len())?;
+
+                for (mov, visits, q, draw) in stats {
+                    writeln!(writer, "{} {} {} {}", pos.conv_mov_to_str(mov), visits, q, draw)?;
+                }
+
+                writeln!(writer, "done")?;
+            }
+            Some("quit") => return Ok(()),
+            _ => {}
+        }
+    }
+
+    Ok(())
+}
+
+fn query_worker(addr: &str, movetime: u128, fen: &str) -> std::io::Result<Vec<RootStat>> {
+    let stream = TcpStream::connect(addr)?;
+    let mut writer = stream.try_clone()?;
+    let mut reader = BufReader::new(stream);
+
+    writeln!(writer, "search {movetime} {fen}")?;
+
+    let mut line = String::new();
+    let mut stats = Vec::new();
+
+    loop {
+        line.clear();
+
+        if reader.read_line(&mut line)? == 0 {
+            break;
+        }
+
+        let trimmed = line.trim();
+
+        if trimmed == "done" {
+            break;
+        }
+
+        let fields: Vec<&str> = trimmed.split(' ').collect();
+
+        if fields.len() == 4 {
+            if let (mov, Ok(visits), Ok(q), Ok(draw)) = (
+                fields[0].to_string(),
+                fields[1].parse(),
+                fields[2].parse(),
+                fields[3].parse(),
+            ) {
+                stats.push((mov, visits, q, draw));
+            }
+        }
+    }
+
+    Ok(stats)
+}
+
+/// Search the current position locally for `movetime` while every worker
+/// does the same, then fold the workers' root statistics into the local
+/// root distribution and report the merged best move.
+#[allow(clippy::too_many_arguments)]
+pub fn coordinate(
+    workers: &[&str],
+    movetime: u128,
+    tree: &mut Tree,
+    pos: &ChessState,
+    params: &MctsParams,
+    policy: &PolicyNetwork,
+    value: &ValueNetwork,
+    threads: usize,
+) {
+    tree.set_root_position(pos);
+
+    let fen = pos.board().as_fen();
+    let abort = AtomicBool::new(false);
+
+    let mut reports: Vec<Vec<RootStat>> = Vec::new();
+
+    std::thread::scope(|s| {
+        let handles: Vec<_> = workers
+            .iter()
+            .map(|&addr| {
+                let fen = fen.clone();
+                s.spawn(move || match query_worker(addr, movetime, &fen) {
+                    Ok(stats) => stats,
+                    Err(e) => {
+                        println!("info string worker {addr} failed: {e}");
+                        Vec::new()
+                    }
+                })
+            })
+            .collect();
+
+        let searcher = Searcher::new(tree, params, policy, value, &abort);
+
+        #[cfg(not(feature = "datagen"))]
+        searcher.search(threads, search_limits(movetime), false, 1, false, &mut 0);
+        #[cfg(feature = "datagen")]
+        searcher.search(
+            threads,
+            search_limits(movetime),
+            false,
+            1,
+            false,
+            &mut 0,
+            false,
+            1.0,
+        );
+
+        for handle in handles {
+            reports.push(handle.join().unwrap_or_default());
+        }
+    });
+
+    let mut merged = 0;
+
+    for stats in &reports {
+        for (mov, visits, q, draw) in stats {
+            if tree.merge_root_child(mov, pos, *visits, *q, *draw) {
+                merged += 1;
+            }
+        }
+    }
+
+    println!("info string merged {merged} root stats from {} workers", reports.len());
+
+    let root = tree.root_node();
+    let best = tree.get_best_child(root);
+
+    if best != usize::MAX {
+        let mov = tree[tree[root].actions() + best].parent_move();
+        println!("bestmove {}", pos.conv_mov_to_str(mov));
+    } else {
+        println!("bestmove 0000");
+    }
+}
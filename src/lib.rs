@@ -1,4 +1,5 @@
 pub mod chess;
+pub mod distributed;
 pub mod mcts;
 pub mod networks;
 pub mod tree;
@@ -63,12 +64,33 @@ pub unsafe fn boxed_and_zeroed<T>() -> Box<T> {
     }
 }
 
+/// Tell the kernel the whole weight mapping will be needed so readahead
+/// happens up front, and optionally (MONTY_PREFAULT=1) touch every page
+/// eagerly so the first search pays no page-fault stalls at all.
+pub fn advise_weights(mmap: &Mmap) {
+    #[cfg(unix)]
+    let _ = mmap.advise(memmap2::Advice::WillNeed);
+
+    if std::env::var("MONTY_PREFAULT").as_deref() == Ok("1") {
+        const PAGE: usize = 4096;
+        let mut sink = 0u8;
+
+        for offset in (0..mmap.len()).step_by(PAGE) {
+            sink = sink.wrapping_add(unsafe { std::ptr::read_volatile(mmap.as_ptr().add(offset)) });
+        }
+
+        std::hint::black_box(sink);
+    }
+}
+
 /// # Safety
 /// Only to be used internally.
 pub unsafe fn read_into_struct_unchecked<'a, T>(path: &str) -> MappedWeights<'a, T> {
     let f = std::fs::File::open(path).unwrap();
     let mmap = Mmap::map(&f).unwrap();
 
+    advise_weights(&mmap);
+
     let size = std::mem::size_of::<T>();
     let file_size = mmap.len();
     assert_eq!(
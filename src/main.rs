@@ -214,6 +214,9 @@ mod net {
         let value_mmap =
             unsafe { Mmap::map(&value_file).expect("Failed to memory-map value network file") };
 
+        monty::advise_weights(&policy_mmap);
+        monty::advise_weights(&value_mmap);
+
         (policy_mmap, value_mmap)
     });
 
@@ -236,6 +239,17 @@ mod net {
             return;
         }
 
+        if let Some("worker") = arg1.as_deref() {
+            let addr = arg2.expect("usage: monty worker <bind-addr> [threads]");
+            let threads = std::env::args()
+                .nth(3)
+                .and_then(|t| t.parse().ok())
+                .unwrap_or(1);
+
+            monty::distributed::run_worker(&addr, threads, policy, value);
+            return;
+        }
+
         let tcec_mode = matches!(arg1.as_deref(), Some("tcec"));
 
         uci::run(policy, value, tcec_mode);
@@ -273,6 +287,17 @@ mod nonet {
             return;
         }
 
+        if let Some("worker") = arg1.as_deref() {
+            let addr = arg2.expect("usage: monty worker <bind-addr> [threads]");
+            let threads = std::env::args()
+                .nth(3)
+                .and_then(|t| t.parse().ok())
+                .unwrap_or(1);
+
+            monty::distributed::run_worker(&addr, threads, policy, value);
+            return;
+        }
+
         let tcec_mode = matches!(arg1.as_deref(), Some("tcec"));
 
         uci::run(policy, value, tcec_mode);
@@ -1,6 +1,8 @@
 mod helpers;
 mod iteration;
 mod params;
+#[cfg(feature = "profile")]
+pub mod profile;
 mod search_stats;
 
 pub use helpers::SearchHelpers;
@@ -62,6 +64,97 @@ fn calibrate_wdl(win: f32, draw: f32, loss: f32) -> [f32; 3] {
     [(e0 / sum) as f32, (e1 / sum) as f32, (e2 / sum) as f32]
 }
 
+/// Iteration counts at which the clock thread last ran each piece of
+/// cadenced bookkeeping, replacing the old is_multiple_of gates now that
+/// checks are driven by wall clock rather than by the main playout loop.
+#[derive(Default)]
+struct LimitCheckpoints {
+    soft_time: usize,
+    instability_reset: usize,
+    scheduler_ticks: usize,
+    /// Last average depth announced with an info line.
+    #[cfg(not(feature = "uci-minimal"))]
+    reported_depth: usize,
+}
+
+/// Cadenced bookkeeping that must keep exact iteration granularity and
+/// therefore stays on the main playout thread rather than the clock thread:
+/// the KLD stop (evaluated per iteration, as its gain normalisation
+/// assumes) and best-move-change sampling (every 128 iterations, which a
+/// millisecond tick undersamples past ~128k iters/s).
+#[derive(Default)]
+struct MainThreadState {
+    best_move: Move,
+    best_move_check: usize,
+    /// Reused KLD buffers, so the per-iteration check is allocation free.
+    #[cfg(feature = "datagen")]
+    kld_previous: Vec<i32>,
+    #[cfg(feature = "datagen")]
+    kld_scratch: Vec<i32>,
+}
+
+/// Memoised PV lines per root move: a line is only re-extracted when its
+/// root child has received visits since it was last built (or a deeper
+/// extraction is requested), so info output with high MultiPV does not
+/// re-walk settled lines. Entries are keyed on the root move itself, which
+/// is stable across half-flip relocation and distinguishes unvisited
+/// children (whose child pointers may all be null).
+#[derive(Default)]
+struct PvCache {
+    entries: Vec<PvCacheEntry>,
+    stamp: u64,
+}
+
+/// More than enough for MultiPV's cap of ten plus best-move churn.
+const PV_CACHE_MAX_ENTRIES: usize = 64;
+
+struct PvCacheEntry {
+    mov: Move,
+    visits: u64,
+    depth: usize,
+    stamp: u64,
+    line: PvLine,
+}
+
+impl PvCache {
+    fn get(&self, mov: Move, visits: u64, depth: usize) -> Option<PvLine> {
+        self.entries
+            .iter()
+            .find(|e| e.mov == mov && e.visits == visits && e.depth >= depth)
+            .map(|e| e.line.clone())
+    }
+
+    fn put(&mut self, mov: Move, visits: u64, depth: usize, line: PvLine) {
+        self.stamp += 1;
+        let stamp = self.stamp;
+
+        if let Some(entry) = self.entries.iter_mut().find(|e| e.mov == mov) {
+            entry.visits = visits;
+            entry.depth = depth;
+            entry.stamp = stamp;
+            entry.line = line;
+            return;
+        }
+
+        let entry = PvCacheEntry {
+            mov,
+            visits,
+            depth,
+            stamp,
+            line,
+        };
+
+        if self.entries.len() >= PV_CACHE_MAX_ENTRIES {
+            // recycle the least recently refreshed slot
+            if let Some(oldest) = self.entries.iter_mut().min_by_key(|e| e.stamp) {
+                *oldest = entry;
+            }
+        } else {
+            self.entries.push(entry);
+        }
+    }
+}
+
 #[derive(Clone, Copy)]
 pub struct Limits {
     pub max_time: Option<u128>,
@@ -97,77 +190,65 @@ impl<'a> Searcher<'a> {
         }
     }
 
-    #[allow(clippy::too_many_arguments)]
-    fn playout_until_full_main(
+    fn playout_until_full_worker(
         &self,
         limits: &Limits,
-        timer: &Instant,
-        #[cfg(not(feature = "uci-minimal"))] timer_last_output: &mut Instant,
         search_stats: &SearchStats,
-        best_move: &mut Move,
-        best_move_changes: &mut i32,
-        previous_score: &mut f32,
-        #[cfg(feature = "datagen")] previous_kld: &mut Vec<i32>,
-        #[cfg(not(feature = "uci-minimal"))] uci_output: bool,
-        #[cfg(not(feature = "uci-minimal"))] multipv: usize,
-        #[cfg(not(feature = "uci-minimal"))] gui_compatibility: bool,
         thread_id: usize,
+        mut main: Option<(&mut MainThreadState, &std::sync::atomic::AtomicI32)>,
     ) {
-        if self.playout_until_full_internal(search_stats, true, thread_id, || {
-            self.check_limits(
-                limits,
-                timer,
-                #[cfg(not(feature = "uci-minimal"))]
-                timer_last_output,
-                search_stats,
-                best_move,
-                best_move_changes,
-                previous_score,
-                #[cfg(feature = "datagen")]
-                previous_kld,
-                #[cfg(not(feature = "uci-minimal"))]
-                uci_output,
-                #[cfg(not(feature = "uci-minimal"))]
-                multipv,
-                #[cfg(not(feature = "uci-minimal"))]
-                gui_compatibility,
-            )
-        }) {
+        // a `true` return means searching is finished (root proven terminal
+        // or a stop was observed) rather than the tree half filling up, so
+        // make sure the other threads and the clock thread wind down too
+        if self.playout_until_full_internal(limits, search_stats, &mut main, thread_id) {
             self.abort.store(true, Ordering::Relaxed);
         }
     }
 
-    fn playout_until_full_worker(&self, search_stats: &SearchStats, thread_id: usize) {
-        let _ = self.playout_until_full_internal(search_stats, false, thread_id, || false);
-    }
-
-    fn playout_until_full_internal<F>(
+    fn playout_until_full_internal(
         &self,
+        limits: &Limits,
         search_stats: &SearchStats,
-        main_thread: bool,
+        main: &mut Option<(&mut MainThreadState, &std::sync::atomic::AtomicI32)>,
         thread_id: usize,
-        mut stop: F,
-    ) -> bool
-    where
-        F: FnMut() -> bool,
-    {
+    ) -> bool {
+        let main_thread = main.is_some();
+        let batch_size = self.params.batch_size() as usize;
+        let mut value_state = crate::networks::IncrementalState::boxed();
+
         loop {
-            let mut pos = self.tree.root_position().clone();
-            let mut this_depth = 0;
-
-            if iteration::perform_one(
-                self,
-                &mut pos,
-                self.tree.root_node(),
-                &mut this_depth,
-                thread_id,
-            )
-            .is_none()
-            {
-                return false;
-            }
+            if batch_size > 1 {
+                if iteration::perform_batch(
+                    self,
+                    search_stats,
+                    batch_size,
+                    main_thread,
+                    thread_id,
+                    &mut value_state,
+                )
+                .is_none()
+                {
+                    return false;
+                }
+            } else {
+                let mut pos = self.tree.root_position().clone();
+                let mut this_depth = 0;
+
+                if iteration::perform_one(
+                    self,
+                    &mut pos,
+                    self.tree.root_node(),
+                    &mut this_depth,
+                    thread_id,
+                    &mut value_state,
+                )
+                .is_none()
+                {
+                    return false;
+                }
 
-            search_stats.add_iter(thread_id, this_depth, main_thread);
+                search_stats.add_iter(thread_id, this_depth, main_thread);
+            }
 
             // proven checkmate
             if self.tree[self.tree.root_node()].is_terminal() {
@@ -179,8 +260,113 @@ impl<'a> Searcher<'a> {
                 return true;
             }
 
-            if stop() {
-                return true;
+            // the count-based limits and iteration-cadenced bookkeeping are
+            // handled here rather than on the clock thread so node- and
+            // depth-limited runs (in particular `bench`) remain exactly
+            // reproducible and the cadences do not coarsen with NPS
+            if let Some((state, best_move_changes)) = main.as_mut() {
+                let iters = search_stats.total_iters();
+
+                if iters >= limits.max_nodes {
+                    return true;
+                }
+
+                let total_depth = search_stats.total_nodes() - iters;
+                let new_depth = total_depth / iters;
+                if new_depth > search_stats.avg_depth.load(Ordering::Relaxed) {
+                    search_stats.avg_depth.store(new_depth, Ordering::Relaxed);
+                }
+
+                if new_depth >= limits.max_depth {
+                    return true;
+                }
+
+                #[cfg(feature = "datagen")]
+                if let Some(min_gain) = limits.kld_min_gain {
+                    self.tree.root_visit_distribution_into(&mut state.kld_scratch);
+
+                    if let Some(kld_gain) =
+                        Node::kld_gain(&state.kld_scratch, &state.kld_previous)
+                    {
+                        if kld_gain < min_gain {
+                            return true;
+                        }
+                    }
+
+                    std::mem::swap(&mut state.kld_previous, &mut state.kld_scratch);
+                }
+
+                if iters - state.best_move_check >= 128 {
+                    state.best_move_check = iters;
+
+                    let (_, new_best_move, _) = self.get_best_action(self.tree.root_node());
+                    if new_best_move != state.best_move {
+                        state.best_move = new_best_move;
+                        best_move_changes.fetch_add(1, Ordering::Relaxed);
+                    }
+                }
+            }
+        }
+    }
+
+    /// The dedicated clock thread: owns all limit enforcement and flips the
+    /// shared abort flag, so playout threads only ever load one atomic. It
+    /// ticks every millisecond, which also bounds how far a hard time limit
+    /// can be overshot regardless of how slow individual playouts are.
+    #[allow(clippy::too_many_arguments)]
+    fn limits_thread(
+        &self,
+        limits: &Limits,
+        timer: &Instant,
+        #[cfg(not(feature = "uci-minimal"))] timer_last_output: &mut Instant,
+        search_stats: &SearchStats,
+        best_move_changes: &std::sync::atomic::AtomicI32,
+        previous_score: &mut f32,
+        #[cfg(not(feature = "uci-minimal"))] uci_output: bool,
+        #[cfg(not(feature = "uci-minimal"))] multipv: usize,
+        #[cfg(not(feature = "uci-minimal"))] gui_compatibility: bool,
+        active_workers: &std::sync::atomic::AtomicUsize,
+        checkpoints: &mut LimitCheckpoints,
+        #[cfg(not(feature = "uci-minimal"))] pv_cache: &mut PvCache,
+    ) {
+        loop {
+            if self.abort.load(Ordering::Relaxed) {
+                return;
+            }
+
+            // the round is over (tree half filled); let the scope close
+            if active_workers.load(Ordering::Relaxed) == 0 {
+                return;
+            }
+
+            thread::sleep(std::time::Duration::from_millis(1));
+
+            checkpoints.scheduler_ticks += 1;
+            if checkpoints.scheduler_ticks >= 100 {
+                checkpoints.scheduler_ticks = 0;
+                self.tree.adapt_scheduler();
+            }
+
+            if self.check_limits(
+                limits,
+                timer,
+                #[cfg(not(feature = "uci-minimal"))]
+                timer_last_output,
+                search_stats,
+                best_move_changes,
+                previous_score,
+                #[cfg(not(feature = "uci-minimal"))]
+                uci_output,
+                #[cfg(not(feature = "uci-minimal"))]
+                multipv,
+                #[cfg(not(feature = "uci-minimal"))]
+                gui_compatibility,
+                checkpoints,
+                #[cfg(not(feature = "uci-minimal"))]
+                pv_cache,
+            ) {
+                self.abort.store(true, Ordering::Relaxed);
+                return;
             }
         }
     }
@@ -192,66 +378,40 @@ impl<'a> Searcher<'a> {
         timer: &Instant,
         #[cfg(not(feature = "uci-minimal"))] timer_last_output: &mut Instant,
         search_stats: &SearchStats,
-        best_move: &mut Move,
-        best_move_changes: &mut i32,
+        best_move_changes: &std::sync::atomic::AtomicI32,
         previous_score: &mut f32,
-        #[cfg(feature = "datagen")] previous_kld_state: &mut Vec<i32>,
         #[cfg(not(feature = "uci-minimal"))] uci_output: bool,
         #[cfg(not(feature = "uci-minimal"))] multipv: usize,
         #[cfg(not(feature = "uci-minimal"))] gui_compatibility: bool,
+        checkpoints: &mut LimitCheckpoints,
+        #[cfg(not(feature = "uci-minimal"))] pv_cache: &mut PvCache,
     ) -> bool {
-        let iters = search_stats.main_iters();
+        let iters = search_stats.total_iters();
 
-        if search_stats.total_iters() >= limits.max_nodes {
+        if iters >= limits.max_nodes {
             return true;
         }
 
-        #[cfg(feature = "datagen")]
-        {
-            if let Some(min_gain) = limits.kld_min_gain {
-                let node = &self.tree[self.tree.root_node()];
-                let child_ptr = node.actions();
-
-                // Force i32 element type
-                let mut visit_dist: Vec<i32> = vec![0; node.num_actions()];
-
-                for (action, visits) in visit_dist.iter_mut().enumerate() {
-                    let v = self.tree[child_ptr + action].visits();
-                    // Saturate to i32::MAX (works whether visits() is u64, or usize)
-                    let v_i32 = (v as i64).min(i32::MAX as i64) as i32;
-                    *visits = v_i32;
-                }
-
-                if let Some(kld_gain) = Node::kld_gain(&visit_dist, previous_kld_state) {
-                    if kld_gain < min_gain {
-                        return true;
-                    }
-                }
-                *previous_kld_state = visit_dist;
-            }
+        if iters == 0 {
+            return false;
         }
 
-        if iters.is_multiple_of(128) {
-            if let Some(time) = limits.max_time {
-                if timer.elapsed().as_millis() >= time {
-                    return true;
-                }
-            }
-
-            let (_, new_best_move, _) = self.get_best_action(self.tree.root_node());
-            if new_best_move != *best_move {
-                *best_move = new_best_move;
-                *best_move_changes += 1;
+        // hard time limit is enforced on every tick
+        if let Some(time) = limits.max_time {
+            if timer.elapsed().as_millis() >= time {
+                return true;
             }
         }
 
-        if iters.is_multiple_of(4096) {
+        if iters - checkpoints.soft_time >= 4096 {
+            checkpoints.soft_time = iters;
+
             if let Some(time) = limits.opt_time {
                 let (should_stop, score) = SearchHelpers::soft_time_cutoff(
                     self,
                     timer,
                     *previous_score,
-                    *best_move_changes,
+                    best_move_changes.load(Ordering::Relaxed),
                     iters,
                     time,
                 );
@@ -260,8 +420,9 @@ impl<'a> Searcher<'a> {
                     return true;
                 }
 
-                if iters.is_multiple_of(16384) {
-                    *best_move_changes = 0;
+                if iters - checkpoints.instability_reset >= 16384 {
+                    checkpoints.instability_reset = iters;
+                    best_move_changes.store(0, Ordering::Relaxed);
                 }
 
                 *previous_score = if *previous_score == f32::NEG_INFINITY {
@@ -277,28 +438,40 @@ impl<'a> Searcher<'a> {
         let new_depth = total_depth / search_stats.total_iters();
         if new_depth > search_stats.avg_depth.load(Ordering::Relaxed) {
             search_stats.avg_depth.store(new_depth, Ordering::Relaxed);
-            if new_depth >= limits.max_depth {
-                return true;
-            }
+        }
 
-            #[cfg(not(feature = "uci-minimal"))]
-            if uci_output {
-                self.search_report(
-                    new_depth,
-                    search_stats.seldepth(),
-                    timer,
-                    search_stats.total_nodes(),
-                    search_stats.total_iters(),
-                    multipv,
-                    gui_compatibility,
-                );
+        if new_depth >= limits.max_depth {
+            return true;
+        }
 
-                *timer_last_output = Instant::now();
-            }
+        // the main playout thread also advances avg_depth (for exact
+        // depth-limit enforcement), so announce against our own record of
+        // what was last reported rather than against the shared maximum
+        let depth_now = search_stats.avg_depth.load(Ordering::Relaxed).max(new_depth);
+
+        #[cfg(not(feature = "uci-minimal"))]
+        if uci_output && depth_now > checkpoints.reported_depth {
+            checkpoints.reported_depth = depth_now;
+
+            self.search_report(
+                depth_now,
+                search_stats.seldepth(),
+                timer,
+                search_stats.total_nodes(),
+                search_stats.total_iters(),
+                multipv,
+                gui_compatibility,
+                pv_cache,
+            );
+
+            *timer_last_output = Instant::now();
         }
 
+        #[cfg(feature = "uci-minimal")]
+        let _ = depth_now;
+
         #[cfg(not(feature = "uci-minimal"))]
-        if uci_output && iters.is_multiple_of(8192) && timer_last_output.elapsed().as_secs() >= 1 {
+        if uci_output && timer_last_output.elapsed().as_secs() >= 1 {
             self.search_report(
                 search_stats.avg_depth.load(Ordering::Relaxed),
                 search_stats.seldepth(),
@@ -307,6 +480,7 @@ impl<'a> Searcher<'a> {
                 search_stats.total_iters(),
                 multipv,
                 gui_compatibility,
+                pv_cache,
             );
 
             *timer_last_output = Instant::now();
@@ -384,40 +558,58 @@ impl<'a> Searcher<'a> {
         let search_stats = SearchStats::new(threads);
         let stats_ref = &search_stats;
 
-        let mut best_move = Move::NULL;
-        let mut best_move_changes = 0;
+        let best_move_changes = std::sync::atomic::AtomicI32::new(0);
         let mut previous_score = f32::NEG_INFINITY;
-        #[cfg(feature = "datagen")]
-        let mut previous_kld = Vec::new();
+        let mut checkpoints = LimitCheckpoints::default();
+        let mut pv_cache = PvCache::default();
+        let mut main_state = MainThreadState::default();
 
         // search loop
         while !self.abort.load(Ordering::Relaxed) {
+            let active_workers = std::sync::atomic::AtomicUsize::new(threads);
+
             thread::scope(|s| {
-                s.spawn(|| {
-                    self.playout_until_full_main(
-                        &limits,
-                        &timer,
-                        #[cfg(not(feature = "uci-minimal"))]
-                        &mut timer_last_output,
+                let active_ref = &active_workers;
+                let limits_ref = &limits;
+                let bmc_ref = &best_move_changes;
+                let main_ref = &mut main_state;
+
+                s.spawn(move || {
+                    self.playout_until_full_worker(
+                        limits_ref,
                         stats_ref,
-                        &mut best_move,
-                        &mut best_move_changes,
-                        &mut previous_score,
-                        #[cfg(feature = "datagen")]
-                        &mut previous_kld,
-                        #[cfg(not(feature = "uci-minimal"))]
-                        uci_output,
-                        #[cfg(not(feature = "uci-minimal"))]
-                        multipv,
-                        #[cfg(not(feature = "uci-minimal"))]
-                        gui_compatibility,
                         0,
+                        Some((main_ref, bmc_ref)),
                     );
+                    active_ref.fetch_sub(1, Ordering::Relaxed);
                 });
 
                 for i in 1..threads {
-                    s.spawn(move || self.playout_until_full_worker(stats_ref, i));
+                    s.spawn(move || {
+                        self.playout_until_full_worker(limits_ref, stats_ref, i, None);
+                        active_ref.fetch_sub(1, Ordering::Relaxed);
+                    });
                 }
+
+                self.limits_thread(
+                    &limits,
+                    &timer,
+                    #[cfg(not(feature = "uci-minimal"))]
+                    &mut timer_last_output,
+                    stats_ref,
+                    &best_move_changes,
+                    &mut previous_score,
+                    #[cfg(not(feature = "uci-minimal"))]
+                    uci_output,
+                    #[cfg(not(feature = "uci-minimal"))]
+                    multipv,
+                    #[cfg(not(feature = "uci-minimal"))]
+                    gui_compatibility,
+                    active_ref,
+                    &mut checkpoints,
+                    #[cfg(not(feature = "uci-minimal"))]
+                    &mut pv_cache,
+                );
             });
 
             if !self.abort.load(Ordering::Relaxed) {
@@ -438,6 +630,7 @@ impl<'a> Searcher<'a> {
                 search_stats.total_iters(),
                 multipv,
                 gui_compatibility,
+                &mut pv_cache,
             );
         }
 
@@ -456,6 +649,7 @@ impl<'a> Searcher<'a> {
         }
     }
 
+    #[allow(clippy::too_many_arguments)]
     #[allow(clippy::too_many_arguments)]
     fn search_report(
         &self,
@@ -466,9 +660,10 @@ impl<'a> Searcher<'a> {
         iters: usize,
         multipv: usize,
         gui_compatibility: bool,
+        pv_cache: &mut PvCache,
     ) {
         let elapsed = timer.elapsed();
-        let pv_lines = self.multipv_lines(depth, seldepth, nodes, multipv);
+        let pv_lines = self.multipv_lines(depth, seldepth, nodes, multipv, pv_cache);
 
         let elapsed_secs = elapsed.as_secs_f32();
         let ms = elapsed.as_millis();
@@ -580,6 +775,7 @@ impl<'a> Searcher<'a> {
         seldepth: usize,
         nodes: usize,
         multipv: usize,
+        pv_cache: &mut PvCache,
     ) -> Vec<PvLine> {
         let children = self.root_children_by_score(multipv.max(1));
 
@@ -597,7 +793,21 @@ impl<'a> Searcher<'a> {
 
         let mut lines: Vec<PvLine> = children
             .into_iter()
-            .map(|(ptr, mov)| self.build_pv_line(ptr, mov, depth))
+            .map(|(ptr, mov)| {
+                let visits = if ptr.is_null() {
+                    0
+                } else {
+                    self.tree[ptr].visits()
+                };
+
+                if let Some(line) = pv_cache.get(mov, visits, depth) {
+                    return line;
+                }
+
+                let line = self.build_pv_line(ptr, mov, depth);
+                pv_cache.put(mov, visits, depth, line.clone());
+                line
+            })
             .collect();
 
         if multipv == 1 {
@@ -752,6 +962,7 @@ impl<'a> Searcher<'a> {
     }
 }
 
+#[derive(Clone)]
 struct PvLine {
     line: Vec<Move>,
     score: f32,
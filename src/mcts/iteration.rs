@@ -1,9 +1,12 @@
+use std::mem::MaybeUninit;
+
 use crate::{
-    chess::{ChessState, GameState},
+    chess::{ChessState, GameState, Move},
+    networks::IncrementalState,
     tree::{Node, NodePtr},
 };
 
-use super::{SearchHelpers, Searcher};
+use super::{SearchHelpers, SearchStats, Searcher};
 
 pub fn perform_one(
     searcher: &Searcher,
@@ -11,6 +14,7 @@ pub fn perform_one(
     ptr: NodePtr,
     depth: &mut usize,
     thread_id: usize,
+    value_state: &mut IncrementalState,
 ) -> Option<(f32, f32)> {
     *depth += 1;
 
@@ -30,14 +34,17 @@ pub fn perform_one(
             if let Some(entry) = tree.probe_hash(cur_hash) {
                 (entry.q(), entry.d())
             } else {
-                get_utility(searcher, ptr, pos)
+                get_utility(searcher, ptr, pos, value_state)
             }
         } else {
-            get_utility(searcher, ptr, pos)
+            get_utility(searcher, ptr, pos, value_state)
         }
     } else {
         // expand node on the second visit
         if node.is_not_expanded() {
+            #[cfg(feature = "profile")]
+            let start = super::profile::now();
+
             tree.expand_node(
                 ptr,
                 pos,
@@ -46,6 +53,9 @@ pub fn perform_one(
                 *depth,
                 thread_id,
             )?;
+
+            #[cfg(feature = "profile")]
+            super::profile::add(&super::profile::EXPANSION, start);
         }
 
         // this node has now been accessed so we need to move its
@@ -54,7 +64,7 @@ pub fn perform_one(
 
         // select action to take via PUCT
         let stm = pos.stm();
-        let action = pick_action(searcher, ptr, node);
+        let action = pick_action(searcher, ptr, node, thread_id);
 
         let child_ptr = node.actions() + action;
 
@@ -65,6 +75,10 @@ pub fn perform_one(
         // capture child hash (value is stored from the side to move at this child)
         child_hash = Some(pos.hash());
 
+        // warm the eval-cache bucket for the position we are descending
+        // into, so a leaf probe below finds it resident
+        tree.prefetch_eval_cache(pos.hash());
+
         child_visits = tree[child_ptr].visits();
         tree[child_ptr].inc_threads();
 
@@ -77,7 +91,7 @@ pub fn perform_one(
         };
 
         // descend further
-        let maybe_u = perform_one(searcher, pos, child_ptr, depth, thread_id);
+        let maybe_u = perform_one(searcher, pos, child_ptr, depth, thread_id, value_state);
 
         drop(lock);
 
@@ -95,6 +109,9 @@ pub fn perform_one(
     };
 
     // store value for the side to move at the visited node in TT
+    #[cfg(feature = "profile")]
+    let start = super::profile::now();
+
     if let Some(h) = child_hash {
         // `u` here is from the current node's perspective, so flip for the child
         tree.push_hash(h, 1.0 - value.0, value.1, child_visits);
@@ -105,17 +122,225 @@ pub fn perform_one(
     // flip perspective and backpropagate
     value.0 = 1.0 - value.0;
     tree.update_node_stats(ptr, value.0, value.1, thread_id);
+
+    #[cfg(feature = "profile")]
+    super::profile::add(&super::profile::BACKUP, start);
+
     Some(value)
 }
 
-fn get_utility(searcher: &Searcher, ptr: NodePtr, pos: &ChessState) -> (f32, f32) {
+/// One step of a recorded descent path, holding everything the deferred
+/// backpropagation needs to mirror what `perform_one` does on unwind.
+struct Edge {
+    parent: NodePtr,
+    child: NodePtr,
+    child_hash: u64,
+    child_visits: u64,
+    mov: Move,
+    stm: usize,
+}
+
+struct PendingLeaf {
+    edges: Vec<Edge>,
+    leaf: NodePtr,
+    pos: ChessState,
+    depth: usize,
+}
+
+/// Batched-iteration mode: collect up to `batch_size` leaves per pass, with
+/// the virtual loss left in place along each path to diversify subsequent
+/// descents, then evaluate the pending leaves back-to-back so consecutive
+/// network passes reuse the streamed weights, and finally back them all up.
+pub fn perform_batch(
+    searcher: &Searcher,
+    search_stats: &SearchStats,
+    batch_size: usize,
+    main_thread: bool,
+    thread_id: usize,
+    value_state: &mut IncrementalState,
+) -> Option<()> {
+    let tree = searcher.tree;
+    let mut pending: Vec<PendingLeaf> = Vec::with_capacity(batch_size);
+    let mut failed = false;
+
+    'collect: for _ in 0..batch_size {
+        if tree[tree.root_node()].is_terminal() {
+            break;
+        }
+
+        let mut pos = tree.root_position().clone();
+        let mut ptr = tree.root_node();
+        let mut depth = 1;
+        let mut edges: Vec<Edge> = Vec::new();
+
+        // held across the step into a zero-visit child, mirroring the
+        // first-visit lock in perform_one; dropped when this descent ends.
+        // Unlike perform_one it is NOT held across a deferred evaluation:
+        // a batch can hold several of these at once, and parking on
+        // multiple spin locks across the eval phase while other threads do
+        // the same can deadlock. Releasing at pending-push time is safe -
+        // a racing first visit sets the same state from the same position,
+        // and its duplicate eval is absorbed by the eval cache.
+        let mut first_visit_lock = None;
+
+        loop {
+            let node = &tree[ptr];
+
+            if node.is_terminal() || node.visits() == 0 {
+                if node.visits() == 0 {
+                    node.set_state(pos.game_state());
+                }
+
+                if node.state() == GameState::Ongoing {
+                    if let Some(entry) = tree.probe_hash(pos.hash()) {
+                        backprop(searcher, &edges, ptr, pos.hash(), (entry.q(), entry.d()), thread_id);
+                    } else {
+                        pending.push(PendingLeaf { edges, leaf: ptr, pos, depth });
+                        continue 'collect;
+                    }
+                } else {
+                    let value = get_utility(searcher, ptr, &pos, value_state);
+                    backprop(searcher, &edges, ptr, pos.hash(), value, thread_id);
+                }
+
+                search_stats.add_iter(thread_id, depth, main_thread);
+                continue 'collect;
+            }
+
+            drop(first_visit_lock.take());
+
+            if node.is_not_expanded()
+                && tree
+                    .expand_node(ptr, &pos, searcher.params, searcher.policy, depth, thread_id)
+                    .is_none()
+            {
+                undo_virtual_loss(searcher, &edges);
+                failed = true;
+                break 'collect;
+            }
+
+            if tree.fetch_children(ptr, thread_id).is_none() {
+                undo_virtual_loss(searcher, &edges);
+                failed = true;
+                break 'collect;
+            }
+
+            let action = pick_action(searcher, ptr, node, thread_id);
+            let child_ptr = node.actions() + action;
+            let mov = tree[child_ptr].parent_move();
+            let stm = pos.stm();
+
+            pos.make_move(mov);
+
+            tree.prefetch_eval_cache(pos.hash());
+
+            let child_visits = tree[child_ptr].visits();
+            tree[child_ptr].inc_threads();
+
+            // acquire lock to avoid issues with desynced setting of
+            // game state between threads when threads > 1
+            if tree[child_ptr].visits() == 0 {
+                first_visit_lock = Some(node.actions_mut());
+            }
+
+            edges.push(Edge {
+                parent: ptr,
+                child: child_ptr,
+                child_hash: pos.hash(),
+                child_visits,
+                mov,
+                stm,
+            });
+
+            ptr = child_ptr;
+            depth += 1;
+        }
+    }
+
+    // evaluate the collected leaves back-to-back and back each one up;
+    // duplicates within a batch are absorbed by the eval cache
+    for leaf in pending {
+        let value = get_utility(searcher, leaf.leaf, &leaf.pos, value_state);
+        backprop(searcher, &leaf.edges, leaf.leaf, leaf.pos.hash(), value, thread_id);
+        search_stats.add_iter(thread_id, leaf.depth, main_thread);
+    }
+
+    if failed {
+        None
+    } else {
+        Some(())
+    }
+}
+
+fn undo_virtual_loss(searcher: &Searcher, edges: &[Edge]) {
+    for edge in edges {
+        searcher.tree[edge.child].dec_threads();
+    }
+}
+
+/// Mirror of the unwind half of `perform_one` for a recorded path.
+fn backprop(
+    searcher: &Searcher,
+    edges: &[Edge],
+    leaf: NodePtr,
+    leaf_hash: u64,
+    mut value: (f32, f32),
+    thread_id: usize,
+) {
+    let tree = searcher.tree;
+
+    tree.push_hash(leaf_hash, value.0, value.1, 1);
+    value.0 = 1.0 - value.0;
+    tree.update_node_stats(leaf, value.0, value.1, thread_id);
+
+    for edge in edges.iter().rev() {
+        tree[edge.child].dec_threads();
+
+        if tree[edge.child].state() == GameState::Ongoing {
+            tree.update_butterfly(edge.stm, edge.mov, value.0, searcher.params);
+        }
+
+        tree.propogate_proven_mates(edge.parent, tree[edge.child].state());
+
+        tree.push_hash(edge.child_hash, 1.0 - value.0, value.1, edge.child_visits);
+        value.0 = 1.0 - value.0;
+        tree.update_node_stats(edge.parent, value.0, value.1, thread_id);
+    }
+}
+
+fn get_utility(
+    searcher: &Searcher,
+    ptr: NodePtr,
+    pos: &ChessState,
+    value_state: &mut IncrementalState,
+) -> (f32, f32) {
     match searcher.tree[ptr].state() {
         GameState::Ongoing => {
-            let eval = pos.eval_with_contempt(
-                searcher.value,
+            #[cfg(feature = "profile")]
+            let start = super::profile::now();
+
+            let tree = searcher.tree;
+            let hash = pos.hash();
+
+            // cached raw network output is bit-exact, so a hit replaces the
+            // full forward pass
+            let raw = if let Some((win, draw)) = tree.probe_eval_cache(hash) {
+                (win, draw, (1.0 - win - draw).max(0.0))
+            } else {
+                let raw = pos.raw_eval_with_state(searcher.value, value_state);
+                tree.push_eval_cache(hash, raw.0, raw.1);
+                raw
+            };
+
+            let eval = pos.eval_with_contempt_from_raw(
+                raw,
                 searcher.params,
-                searcher.tree.root_position().stm(),
+                tree.root_position().stm(),
             );
+
+            #[cfg(feature = "profile")]
+            super::profile::add(&super::profile::VALUE_EVAL, start);
+
             (eval.contempt.score(), eval.contempt.draw)
         }
         GameState::Draw => (0.5, 1.0),
@@ -124,7 +349,10 @@ fn get_utility(searcher: &Searcher, ptr: NodePtr, pos: &ChessState) -> (f32, f32
     }
 }
 
-fn pick_action(searcher: &Searcher, ptr: NodePtr, node: &Node) -> usize {
+fn pick_action(searcher: &Searcher, ptr: NodePtr, node: &Node, thread_id: usize) -> usize {
+    #[cfg(feature = "profile")]
+    let start = super::profile::now();
+
     let is_root = ptr == searcher.tree.root_node();
 
     let cpuct = SearchHelpers::get_cpuct(searcher.params, node, is_root);
@@ -148,22 +376,53 @@ fn pick_action(searcher: &Searcher, ptr: NodePtr, node: &Node) -> usize {
     }
     limit = limit.min(node.num_actions());
 
-    searcher
-        .tree
-        .get_best_child_by_key_lim(ptr, limit, |child| {
-            let mut q = SearchHelpers::get_action_value(child, fpu);
-
-            // virtual loss
-            let threads = f64::from(child.threads());
-            if threads > 0.0 {
-                let visits = child.visits() as f64;
-                let q2 = f64::from(q) * visits
-                    / (visits + 1.0 + searcher.params.virtual_loss_weight() * (threads - 1.0));
-                q = q2 as f32;
-            }
+    // gather the selection-critical stats from the contiguous child nodes
+    // into a stack buffer in one forward sweep, so the argmax below is a
+    // branch-light scan over a flat array rather than a walk over 64-byte
+    // nodes
+    let mut scores = [const { MaybeUninit::<f32>::uninit() }; 256];
+
+    let vl_weight =
+        searcher.params.virtual_loss_weight() * f64::from(searcher.tree.virtual_loss_scale());
+
+    for (action, score) in scores[..limit].iter_mut().enumerate() {
+        let child = &searcher.tree[actions_ptr + action];
+
+        let visits = child.visits();
+        let mut q = SearchHelpers::get_action_value(child, fpu);
+
+        // virtual loss
+        let threads = f64::from(child.threads());
+        if threads > 0.0 {
+            let q2 = f64::from(q) * visits as f64
+                / (visits as f64 + 1.0 + vl_weight * (threads - 1.0));
+            q = q2 as f32;
+        }
+
+        let u = expl * child.policy() / (1 + visits) as f32;
+
+        score.write(q + u);
+    }
+
+    let scores = unsafe { std::slice::from_raw_parts(scores.as_ptr() as *const f32, limit) };
+
+    let mut best_child = usize::MAX;
+    let mut best_score = f32::NEG_INFINITY;
+
+    for (action, &score) in scores.iter().enumerate() {
+        if score > best_score {
+            best_score = score;
+            best_child = action;
+        }
+    }
+
+    if best_child != usize::MAX {
+        let chosen = &searcher.tree[actions_ptr + best_child];
+        searcher.tree.note_selection(thread_id, chosen.threads() > 0);
+    }
 
-            let u = expl * child.policy() / (1 + child.visits()) as f32;
+    #[cfg(feature = "profile")]
+    super::profile::add(&super::profile::SELECTION, start);
 
-            q + u
-        })
+    best_child
 }
@@ -0,0 +1,89 @@
+//! Cycle-level phase attribution behind the `profile` feature.
+//!
+//! External profilers lose MCTS phase boundaries once everything inlines
+//! into the playout loop, so the phases are timed directly: selection,
+//! expansion (policy eval), value eval and backup each accumulate rdtsc
+//! deltas and call counts in relaxed global counters, reported as a
+//! breakdown table at search end.
+
+use std::sync::atomic::{AtomicU64, Ordering};
+
+pub struct Phase {
+    name: &'static str,
+    cycles: AtomicU64,
+    calls: AtomicU64,
+}
+
+impl Phase {
+    const fn new(name: &'static str) -> Self {
+        Self {
+            name,
+            cycles: AtomicU64::new(0),
+            calls: AtomicU64::new(0),
+        }
+    }
+}
+
+pub static SELECTION: Phase = Phase::new("selection");
+pub static EXPANSION: Phase = Phase::new("expansion");
+pub static VALUE_EVAL: Phase = Phase::new("value eval");
+pub static BACKUP: Phase = Phase::new("backup");
+
+const PHASES: [&Phase; 4] = [&SELECTION, &EXPANSION, &VALUE_EVAL, &BACKUP];
+
+#[inline]
+pub fn now() -> u64 {
+    #[cfg(target_arch = "x86_64")]
+    unsafe {
+        core::arch::x86_64::_rdtsc()
+    }
+
+    #[cfg(not(target_arch = "x86_64"))]
+    {
+        use std::time::Instant;
+        static EPOCH: once_cell::sync::Lazy<Instant> = once_cell::sync::Lazy::new(Instant::now);
+        EPOCH.elapsed().as_nanos() as u64
+    }
+}
+
+#[inline]
+pub fn add(phase: &Phase, start: u64) {
+    phase
+        .cycles
+        .fetch_add(now().wrapping_sub(start), Ordering::Relaxed);
+    phase.calls.fetch_add(1, Ordering::Relaxed);
+}
+
+pub fn reset() {
+    for phase in PHASES {
+        phase.cycles.store(0, Ordering::Relaxed);
+        phase.calls.store(0, Ordering::Relaxed);
+    }
+}
+
+pub fn report() {
+    let total: u64 = PHASES
+        .iter()
+        .map(|p| p.cycles.load(Ordering::Relaxed))
+        .sum();
+
+    if total == 0 {
+        return;
+    }
+
+    println!("phase        calls          cycles      cyc/call  share");
+
+    for phase in PHASES {
+        let cycles = phase.cycles.load(Ordering::Relaxed);
+        let calls = phase.calls.load(Ordering::Relaxed).max(1);
+
+        println!(
+            "{:<10} {:>9} {:>15} {:>13} {:>5.1}%",
+            phase.name,
+            calls,
+            cycles,
+            cycles / calls,
+            100.0 * cycles as f64 / total as f64,
+        );
+    }
+}
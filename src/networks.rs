@@ -16,4 +16,4 @@ pub use policy::PolicyFileDefaultName;
 pub use value::ValueFileDefaultName;
 
 pub use policy::{PolicyNetwork, L1 as POLICY_L1};
-pub use value::ValueNetwork;
+pub use value::{IncrementalState, ValueNetwork};
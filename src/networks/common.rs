@@ -1,3 +1,6 @@
+#[cfg(target_arch = "x86_64")]
+pub(super) mod simd;
+
 use std::ops::{AddAssign, Mul};
 
 #[repr(C)]
@@ -28,6 +31,29 @@ impl<T: AddAssign<T> + Copy + Mul<T, Output = T> + From<i16>, const N: usize> Ac
 
 impl<const N: usize> Accumulator<i16, N> {
     pub fn add_multi(&mut self, adds: &[usize], weights: &[Self]) {
+        #[cfg(target_arch = "x86_64")]
+        {
+            debug_assert!(adds.iter().all(|&add| add < weights.len()));
+
+            let base = weights.as_ptr().cast::<i16>();
+
+            match simd::level() {
+                simd::Level::Avx512 => {
+                    unsafe { simd::add_multi_i16_avx512(&mut self.0, adds, base, N) };
+                    return;
+                }
+                simd::Level::Avx2 => {
+                    unsafe { simd::add_multi_i16_avx2(&mut self.0, adds, base, N) };
+                    return;
+                }
+                simd::Level::Scalar => {}
+            }
+        }
+
+        self.add_multi_scalar(adds, weights);
+    }
+
+    fn add_multi_scalar(&mut self, adds: &[usize], weights: &[Self]) {
         const REGS: usize = 8;
         const PER: usize = REGS * 16;
 
@@ -57,6 +83,60 @@ impl<const N: usize> Accumulator<i16, N> {
 
 impl<const N: usize> Accumulator<i16, N> {
     pub fn add_multi_i8(&mut self, adds: &[usize], weights: &[Accumulator<i8, N>]) {
+        #[cfg(target_arch = "x86_64")]
+        {
+            debug_assert!(adds.iter().all(|&add| add < weights.len()));
+
+            let base = weights.as_ptr().cast::<i8>();
+
+            match simd::level() {
+                simd::Level::Avx512 => {
+                    unsafe { simd::add_multi_i8_avx512(&mut self.0, adds, base, N) };
+                    return;
+                }
+                simd::Level::Avx2 => {
+                    unsafe { simd::add_multi_i8_avx2(&mut self.0, adds, base, N) };
+                    return;
+                }
+                simd::Level::Scalar => {}
+            }
+        }
+
+        self.add_multi_i8_scalar(adds, weights);
+    }
+
+    pub fn sub_multi_i8(&mut self, subs: &[usize], weights: &[Accumulator<i8, N>]) {
+        #[cfg(target_arch = "x86_64")]
+        {
+            debug_assert!(subs.iter().all(|&sub| sub < weights.len()));
+
+            let base = weights.as_ptr().cast::<i8>();
+
+            match simd::level() {
+                simd::Level::Avx512 => {
+                    unsafe { simd::sub_multi_i8_avx512(&mut self.0, subs, base, N) };
+                    return;
+                }
+                simd::Level::Avx2 => {
+                    unsafe { simd::sub_multi_i8_avx2(&mut self.0, subs, base, N) };
+                    return;
+                }
+                simd::Level::Scalar => {}
+            }
+        }
+
+        self.sub_multi_i8_scalar(subs, weights);
+    }
+
+    fn sub_multi_i8_scalar(&mut self, subs: &[usize], weights: &[Accumulator<i8, N>]) {
+        for (i, acc) in self.0.iter_mut().enumerate() {
+            for &sub in subs {
+                *acc -= i16::from(weights[sub].0[i]);
+            }
+        }
+    }
+
+    fn add_multi_i8_scalar(&mut self, adds: &[usize], weights: &[Accumulator<i8, N>]) {
         const REGS: usize = 8;
         const PER: usize = REGS * 16;
 
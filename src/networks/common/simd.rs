@@ -0,0 +1,336 @@
+//! Runtime-dispatched x86-64 kernels for the accumulator hot loops.
+//!
+//! The scalar register-blocked loops in `common.rs` remain the reference
+//! implementation (and the only one on non-x86 targets); these kernels are
+//! selected once, on first use, from the features the host actually reports,
+//! so a single binary runs well across a heterogeneous fleet.
+
+use once_cell::sync::Lazy;
+
+#[derive(Clone, Copy, PartialEq, Eq)]
+pub enum Level {
+    Scalar,
+    Avx2,
+    Avx512,
+}
+
+/// Detected once on first use and cached for the lifetime of the process.
+pub static LEVEL: Lazy<Level> = Lazy::new(|| {
+    if is_x86_feature_detected!("avx512f") && is_x86_feature_detected!("avx512bw") {
+        Level::Avx512
+    } else if is_x86_feature_detected!("avx2") {
+        Level::Avx2
+    } else {
+        Level::Scalar
+    }
+});
+
+pub fn level() -> Level {
+    *LEVEL
+}
+
+/// Accumulate the rows `weights[add]` (stride `stride` in elements) into
+/// `acc`, keeping the running sums in registers across all adds.
+///
+/// # Safety
+/// Requires AVX2. Every row referenced by `adds` must be `acc.len()`
+/// elements long and `stride` elements apart starting at `weights`.
+#[target_feature(enable = "avx2")]
+pub unsafe fn add_multi_i16_avx2(acc: &mut [i16], adds: &[usize], weights: *const i16, stride: usize) {
+    use std::arch::x86_64::*;
+
+    const LANES: usize = 16;
+    const REGS: usize = 8;
+    const PER: usize = REGS * LANES;
+
+    let n = acc.len();
+    let ptr = acc.as_mut_ptr();
+    let mut i = 0;
+
+    while i + PER <= n {
+        let mut regs = [_mm256_setzero_si256(); REGS];
+
+        for (j, reg) in regs.iter_mut().enumerate() {
+            *reg = _mm256_loadu_si256(ptr.add(i + j * LANES).cast());
+        }
+
+        for &add in adds {
+            let row = weights.add(add * stride + i);
+
+            for (j, reg) in regs.iter_mut().enumerate() {
+                let w = _mm256_loadu_si256(row.add(j * LANES).cast());
+                *reg = _mm256_add_epi16(*reg, w);
+            }
+        }
+
+        for (j, reg) in regs.iter().enumerate() {
+            _mm256_storeu_si256(ptr.add(i + j * LANES).cast(), *reg);
+        }
+
+        i += PER;
+    }
+
+    while i + LANES <= n {
+        let mut reg = _mm256_loadu_si256(ptr.add(i).cast());
+
+        for &add in adds {
+            let w = _mm256_loadu_si256(weights.add(add * stride + i).cast());
+            reg = _mm256_add_epi16(reg, w);
+        }
+
+        _mm256_storeu_si256(ptr.add(i).cast(), reg);
+
+        i += LANES;
+    }
+
+    for k in i..n {
+        for &add in adds {
+            acc[k] += *weights.add(add * stride + k);
+        }
+    }
+}
+
+/// As `add_multi_i16_avx2`, with 512-bit registers.
+///
+/// # Safety
+/// Requires AVX-512F and AVX-512BW, same layout contract as the AVX2 kernel.
+#[target_feature(enable = "avx512f,avx512bw")]
+pub unsafe fn add_multi_i16_avx512(acc: &mut [i16], adds: &[usize], weights: *const i16, stride: usize) {
+    use std::arch::x86_64::*;
+
+    const LANES: usize = 32;
+    const REGS: usize = 8;
+    const PER: usize = REGS * LANES;
+
+    let n = acc.len();
+    let ptr = acc.as_mut_ptr();
+    let mut i = 0;
+
+    while i + PER <= n {
+        let mut regs = [_mm512_setzero_si512(); REGS];
+
+        for (j, reg) in regs.iter_mut().enumerate() {
+            *reg = _mm512_loadu_si512(ptr.add(i + j * LANES).cast());
+        }
+
+        for &add in adds {
+            let row = weights.add(add * stride + i);
+
+            for (j, reg) in regs.iter_mut().enumerate() {
+                let w = _mm512_loadu_si512(row.add(j * LANES).cast());
+                *reg = _mm512_add_epi16(*reg, w);
+            }
+        }
+
+        for (j, reg) in regs.iter().enumerate() {
+            _mm512_storeu_si512(ptr.add(i + j * LANES).cast(), *reg);
+        }
+
+        i += PER;
+    }
+
+    while i + LANES <= n {
+        let mut reg = _mm512_loadu_si512(ptr.add(i).cast());
+
+        for &add in adds {
+            let w = _mm512_loadu_si512(weights.add(add * stride + i).cast());
+            reg = _mm512_add_epi16(reg, w);
+        }
+
+        _mm512_storeu_si512(ptr.add(i).cast(), reg);
+
+        i += LANES;
+    }
+
+    for k in i..n {
+        for &add in adds {
+            acc[k] += *weights.add(add * stride + k);
+        }
+    }
+}
+
+/// Subtract sign-extended `i8` rows from an `i16` accumulator.
+///
+/// # Safety
+/// Requires AVX2, same layout contract as `add_multi_i16_avx2`.
+#[target_feature(enable = "avx2")]
+pub unsafe fn sub_multi_i8_avx2(acc: &mut [i16], subs: &[usize], weights: *const i8, stride: usize) {
+    use std::arch::x86_64::*;
+
+    const LANES: usize = 16;
+
+    let n = acc.len();
+    let ptr = acc.as_mut_ptr();
+    let mut i = 0;
+
+    while i + LANES <= n {
+        let mut reg = _mm256_loadu_si256(ptr.add(i).cast());
+
+        for &sub in subs {
+            let w = _mm_loadu_si128(weights.add(sub * stride + i).cast());
+            reg = _mm256_sub_epi16(reg, _mm256_cvtepi8_epi16(w));
+        }
+
+        _mm256_storeu_si256(ptr.add(i).cast(), reg);
+
+        i += LANES;
+    }
+
+    for k in i..n {
+        for &sub in subs {
+            acc[k] -= i16::from(*weights.add(sub * stride + k));
+        }
+    }
+}
+
+/// As `sub_multi_i8_avx2`, with 512-bit registers.
+///
+/// # Safety
+/// Requires AVX-512F and AVX-512BW, same layout contract as the AVX2 kernel.
+#[target_feature(enable = "avx512f,avx512bw")]
+pub unsafe fn sub_multi_i8_avx512(acc: &mut [i16], subs: &[usize], weights: *const i8, stride: usize) {
+    use std::arch::x86_64::*;
+
+    const LANES: usize = 32;
+
+    let n = acc.len();
+    let ptr = acc.as_mut_ptr();
+    let mut i = 0;
+
+    while i + LANES <= n {
+        let mut reg = _mm512_loadu_si512(ptr.add(i).cast());
+
+        for &sub in subs {
+            let w = _mm256_loadu_si256(weights.add(sub * stride + i).cast());
+            reg = _mm512_sub_epi16(reg, _mm512_cvtepi8_epi16(w));
+        }
+
+        _mm512_storeu_si512(ptr.add(i).cast(), reg);
+
+        i += LANES;
+    }
+
+    for k in i..n {
+        for &sub in subs {
+            acc[k] -= i16::from(*weights.add(sub * stride + k));
+        }
+    }
+}
+
+/// Accumulate sign-extended `i8` rows into an `i16` accumulator.
+///
+/// # Safety
+/// Requires AVX2, same layout contract as `add_multi_i16_avx2`.
+#[target_feature(enable = "avx2")]
+pub unsafe fn add_multi_i8_avx2(acc: &mut [i16], adds: &[usize], weights: *const i8, stride: usize) {
+    use std::arch::x86_64::*;
+
+    const LANES: usize = 16;
+    const REGS: usize = 8;
+    const PER: usize = REGS * LANES;
+
+    let n = acc.len();
+    let ptr = acc.as_mut_ptr();
+    let mut i = 0;
+
+    while i + PER <= n {
+        let mut regs = [_mm256_setzero_si256(); REGS];
+
+        for (j, reg) in regs.iter_mut().enumerate() {
+            *reg = _mm256_loadu_si256(ptr.add(i + j * LANES).cast());
+        }
+
+        for &add in adds {
+            let row = weights.add(add * stride + i);
+
+            for (j, reg) in regs.iter_mut().enumerate() {
+                let w = _mm_loadu_si128(row.add(j * LANES).cast());
+                *reg = _mm256_add_epi16(*reg, _mm256_cvtepi8_epi16(w));
+            }
+        }
+
+        for (j, reg) in regs.iter().enumerate() {
+            _mm256_storeu_si256(ptr.add(i + j * LANES).cast(), *reg);
+        }
+
+        i += PER;
+    }
+
+    while i + LANES <= n {
+        let mut reg = _mm256_loadu_si256(ptr.add(i).cast());
+
+        for &add in adds {
+            let w = _mm_loadu_si128(weights.add(add * stride + i).cast());
+            reg = _mm256_add_epi16(reg, _mm256_cvtepi8_epi16(w));
+        }
+
+        _mm256_storeu_si256(ptr.add(i).cast(), reg);
+
+        i += LANES;
+    }
+
+    for k in i..n {
+        for &add in adds {
+            acc[k] += i16::from(*weights.add(add * stride + k));
+        }
+    }
+}
+
+/// As `add_multi_i8_avx2`, with 512-bit registers.
+///
+/// # Safety
+/// Requires AVX-512F and AVX-512BW, same layout contract as the AVX2 kernel.
+#[target_feature(enable = "avx512f,avx512bw")]
+pub unsafe fn add_multi_i8_avx512(acc: &mut [i16], adds: &[usize], weights: *const i8, stride: usize) {
+    use std::arch::x86_64::*;
+
+    const LANES: usize = 32;
+    const REGS: usize = 8;
+    const PER: usize = REGS * LANES;
+
+    let n = acc.len();
+    let ptr = acc.as_mut_ptr();
+    let mut i = 0;
+
+    while i + PER <= n {
+        let mut regs = [_mm512_setzero_si512(); REGS];
+
+        for (j, reg) in regs.iter_mut().enumerate() {
+            *reg = _mm512_loadu_si512(ptr.add(i + j * LANES).cast());
+        }
+
+        for &add in adds {
+            let row = weights.add(add * stride + i);
+
+            for (j, reg) in regs.iter_mut().enumerate() {
+                let w = _mm256_loadu_si256(row.add(j * LANES).cast());
+                *reg = _mm512_add_epi16(*reg, _mm512_cvtepi8_epi16(w));
+            }
+        }
+
+        for (j, reg) in regs.iter().enumerate() {
+            _mm512_storeu_si512(ptr.add(i + j * LANES).cast(), *reg);
+        }
+
+        i += PER;
+    }
+
+    while i + LANES <= n {
+        let mut reg = _mm512_loadu_si512(ptr.add(i).cast());
+
+        for &add in adds {
+            let w = _mm256_loadu_si256(weights.add(add * stride + i).cast());
+            reg = _mm512_add_epi16(reg, _mm512_cvtepi8_epi16(w));
+        }
+
+        _mm512_storeu_si512(ptr.add(i).cast(), reg);
+
+        i += LANES;
+    }
+
+    for k in i..n {
+        for &add in adds {
+            acc[k] += i16::from(*weights.add(add * stride + k));
+        }
+    }
+}
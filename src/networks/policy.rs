@@ -77,4 +77,54 @@ impl PolicyNetwork {
 
         (res as f32 / f32::from(QA * FACTOR) + f32::from(self.l2.biases.0[idx])) / f32::from(QB)
     }
+
+    /// Score every move in one blocked matrix-vector pass, tiling over the
+    /// accumulator so it is streamed from cache rather than from memory once
+    /// per move.
+    pub fn get_all(
+        &self,
+        pos: &Position,
+        moves: &[Move],
+        hl: &Accumulator<i16, { L1 / 2 }>,
+        scores: &mut [f32],
+    ) {
+        assert_eq!(moves.len(), scores.len());
+        assert!(moves.len() <= 256);
+
+        const TILE: usize = 512;
+
+        let mut idxs = [0usize; 256];
+        let mut accs = [0i32; 256];
+
+        // pins and friends are shared by every SEE query for this position
+        let see_ctx = see::SeeContext::new(pos);
+
+        for (idx, &mov) in idxs.iter_mut().zip(moves.iter()) {
+            *idx = outputs::map_move_to_index_with(pos, &see_ctx, mov);
+        }
+
+        for start in (0..L1 / 2).step_by(TILE) {
+            let hl_tile = &hl.0[start..start + TILE];
+
+            for (acc, &idx) in accs[..moves.len()].iter_mut().zip(idxs[..moves.len()].iter()) {
+                let row = &self.l2.weights[idx].0[start..start + TILE];
+                let mut sum = 0;
+
+                for (&w, &v) in row.iter().zip(hl_tile.iter()) {
+                    sum += i32::from(w) * i32::from(v);
+                }
+
+                *acc += sum;
+            }
+        }
+
+        for ((score, &acc), &idx) in scores
+            .iter_mut()
+            .zip(accs[..moves.len()].iter())
+            .zip(idxs[..moves.len()].iter())
+        {
+            *score = (acc as f32 / f32::from(QA * FACTOR) + f32::from(self.l2.biases.0[idx]))
+                / f32::from(QB);
+        }
+    }
 }
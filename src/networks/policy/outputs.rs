@@ -11,13 +11,17 @@ pub const FROM_TO: usize = OFFSETS[5][64] + PROMOS + 2 + 8;
 pub const PROMOS: usize = 4 * 22;
 
 pub fn map_move_to_index(pos: &Position, mov: Move) -> usize {
+    map_move_to_index_with(pos, &see::SeeContext::new(pos), mov)
+}
+
+pub fn map_move_to_index_with(pos: &Position, see_ctx: &see::SeeContext, mov: Move) -> usize {
     let hm = if pos.king_index() % 8 > 3 { 7 } else { 0 };
     let flip = hm ^ if pos.stm() == Side::BLACK { 56 } else { 0 };
 
     let src = usize::from(mov.src() ^ flip);
     let dst = usize::from(mov.to() ^ flip);
 
-    let good_see = usize::from(see::greater_or_equal_to(pos, &mov, -108));
+    let good_see = usize::from(see::greater_or_equal_to_with(pos, see_ctx, &mov, -108));
 
     let idx = if mov.is_promo() {
         let ffile = src % 8;
@@ -7,10 +7,34 @@ use crate::pop_lsb;
 
 pub const SEE_VALS: [i32; 8] = [0, 0, 100, 450, 450, 650, 1250, 0];
 
+/// Position-level state shared by every SEE query during one expansion:
+/// the pin computation (two x-ray scans) is the expensive part that is
+/// identical across all the moves scored for a position.
+pub struct SeeContext {
+    pinned: u64,
+}
+
+impl SeeContext {
+    pub fn new(pos: &Position) -> Self {
+        Self {
+            pinned: pos.pinned(),
+        }
+    }
+}
+
+pub fn greater_or_equal_to(pos: &Position, mov: &Move, threshold: i32) -> bool {
+    greater_or_equal_to_with(pos, &SeeContext::new(pos), mov, threshold)
+}
+
 // This has been validated to be nearly fully legal (777/23441654 fails on lichess puzzles, 99.997% legal)
 // See https://github.com/Viren6/Monty/tree/fully-legal-see-5 and
 // https://huggingface.co/datasets/Viren6/SEE
-pub fn greater_or_equal_to(pos: &Position, mov: &Move, threshold: i32) -> bool {
+pub fn greater_or_equal_to_with(
+    pos: &Position,
+    ctx: &SeeContext,
+    mov: &Move,
+    threshold: i32,
+) -> bool {
     let from = mov.src() as usize;
     let to = mov.to() as usize;
     let side = pos.stm();
@@ -24,7 +48,7 @@ pub fn greater_or_equal_to(pos: &Position, mov: &Move, threshold: i32) -> bool {
 
     let from_bb = 1u64 << from;
     let ksq = pos.king_sq(side);
-    let pinned = pos.pinned();
+    let pinned = ctx.pinned;
     if (pinned & from_bb) != 0 && (LINE_THROUGH[ksq][to] & from_bb) == 0 {
         return false;
     }
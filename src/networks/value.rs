@@ -1,6 +1,8 @@
 pub mod attacks;
 pub mod threats;
 
+use std::mem::MaybeUninit;
+
 use montyformat::chess::Position;
 
 use super::common::{Accumulator, Layer, SCReLU, TransposedLayer};
@@ -27,12 +29,34 @@ pub struct ValueNetwork {
     l4: Layer<f32, 128, 3>,
 }
 
+pub const MAX_FEATURES: usize = 160;
+
+/// Per-thread state for incrementally maintained L1 accumulation: the
+/// previous evaluation's sorted feature list and accumulator. Successive
+/// leaves in a playout loop share most of their features, so only the
+/// differing weight rows are added/subtracted (bit-exact integer work);
+/// a large diff - perspective flip, king mirror, or an unrelated position -
+/// falls back to the full rebuild automatically. Must be valid all-zeroed.
+pub struct IncrementalState {
+    valid: bool,
+    count: usize,
+    // feature indices range over threats::TOTAL (80624), which exceeds u16
+    feats: [u32; MAX_FEATURES],
+    acc: Accumulator<i16, L1>,
+}
+
+impl IncrementalState {
+    pub fn boxed() -> Box<Self> {
+        unsafe { crate::boxed_and_zeroed() }
+    }
+}
+
 impl ValueNetwork {
     pub fn eval(&self, board: &Position) -> (f32, f32, f32) {
         let mut pst = Accumulator([0.0; 3]);
 
         let mut count = 0;
-        let mut feats = [0; 160];
+        let mut feats = [0; MAX_FEATURES];
         threats::map_features(board.bbs(), board.stm(), |feat| {
             feats[count] = feat;
             pst.add(&self.pst[feat]);
@@ -47,22 +71,113 @@ impl ValueNetwork {
 
         l2.add_multi_i8(&feats[..count], &self.l1.weights);
 
-        let mut act = [0; L1 / 2];
+        self.forward_from_l1(&l2, &pst)
+    }
+
+    /// As [`eval`](Self::eval), reusing `state` from the caller's previous
+    /// evaluation so most weight-row work is replaced by a small delta.
+    pub fn eval_with_state(
+        &self,
+        board: &Position,
+        state: &mut IncrementalState,
+    ) -> (f32, f32, f32) {
+        // the pst head is a handful of f32 adds: always recomputed fresh so
+        // no floating-point residue can accumulate across updates
+        let mut pst = Accumulator([0.0; 3]);
+
+        let mut count = 0;
+        let mut feats = [0u32; MAX_FEATURES];
+        threats::map_features(board.bbs(), board.stm(), |feat| {
+            feats[count] = feat as u32;
+            pst.add(&self.pst[feat]);
+            count += 1;
+        });
 
-        for (a, (&i, &j)) in act
-            .iter_mut()
-            .zip(l2.0.iter().take(L1 / 2).zip(l2.0.iter().skip(L1 / 2)))
+        feats[..count].sort_unstable();
+
+        let mut adds = [0usize; MAX_FEATURES];
+        let mut subs = [0usize; MAX_FEATURES];
+        let mut num_adds = 0;
+        let mut num_subs = 0;
+
+        if state.valid {
+            // two-pointer diff over the sorted feature lists
+            let (mut i, mut j) = (0, 0);
+
+            while i < count || j < state.count {
+                if j == state.count || (i < count && feats[i] < state.feats[j]) {
+                    adds[num_adds] = feats[i] as usize;
+                    num_adds += 1;
+                    i += 1;
+                } else if i == count || state.feats[j] < feats[i] {
+                    subs[num_subs] = state.feats[j] as usize;
+                    num_subs += 1;
+                    j += 1;
+                } else {
+                    i += 1;
+                    j += 1;
+                }
+            }
+        }
+
+        if state.valid && num_adds + num_subs < count {
+            state.acc.add_multi_i8(&adds[..num_adds], &self.l1.weights);
+            state.acc.sub_multi_i8(&subs[..num_subs], &self.l1.weights);
+        } else {
+            for (r, &b) in state.acc.0.iter_mut().zip(self.l1.biases.0.iter()) {
+                *r = i16::from(b);
+            }
+
+            let mut all = [0usize; MAX_FEATURES];
+            for (slot, &feat) in all.iter_mut().zip(feats.iter()) {
+                *slot = feat as usize;
+            }
+
+            state.acc.add_multi_i8(&all[..count], &self.l1.weights);
+        }
+
+        state.feats = feats;
+        state.count = count;
+        state.valid = true;
+
+        self.forward_from_l1(&state.acc, &pst)
+    }
+
+    fn forward_from_l1(&self, l2: &Accumulator<i16, L1>, pst: &Accumulator<f32, 3>) -> (f32, f32, f32) {
+        // the pairwise-multiply activation is overwhelmingly zero, so gather
+        // the nonzero entries and only push those columns through L2
+        let mut idxs = [const { MaybeUninit::<u16>::uninit() }; L1 / 2];
+        let mut vals = [const { MaybeUninit::<i16>::uninit() }; L1 / 2];
+        let mut nnz = 0;
+
+        for (idx, (&i, &j)) in l2
+            .0
+            .iter()
+            .take(L1 / 2)
+            .zip(l2.0.iter().skip(L1 / 2))
+            .enumerate()
         {
             let i = i.clamp(0, QA);
             let j = j.clamp(0, QA);
-            *a = i * j;
+
+            if i != 0 && j != 0 {
+                idxs[nnz].write(idx as u16);
+                vals[nnz].write(i * j);
+                nnz += 1;
+            }
         }
 
+        let idxs = unsafe { std::slice::from_raw_parts(idxs.as_ptr() as *const u16, nnz) };
+        let vals = unsafe { std::slice::from_raw_parts(vals.as_ptr() as *const i16, nnz) };
+
         let mut fwd = [0; 16];
 
-        for (f, row) in fwd.iter_mut().zip(self.l2.weights.iter()) {
-            for (&a, &w) in act.iter().zip(row.0.iter()) {
-                *f += i32::from(a) * i32::from(w);
+        for (&idx, &val) in idxs.iter().zip(vals.iter()) {
+            let idx = usize::from(idx);
+            let a = i32::from(val);
+
+            for (f, row) in fwd.iter_mut().zip(self.l2.weights.iter()) {
+                *f += a * i32::from(row.0[idx]);
             }
         }
 
@@ -74,7 +189,7 @@ impl ValueNetwork {
 
         let l4 = self.l3.forward::<SCReLU>(&l3);
         let mut out = self.l4.forward::<SCReLU>(&l4);
-        out.add(&pst);
+        out.add(pst);
 
         let mut win = out.0[2];
         let mut draw = out.0[1];
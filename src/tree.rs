@@ -1,8 +1,16 @@
+mod arena;
+#[cfg(feature = "stats")]
+pub mod contention;
+mod eval_cache;
 mod half;
 mod hash;
 mod lock;
 mod node;
+mod policy_cache;
 
+pub use arena::HUGE_PAGES;
+pub use eval_cache::EvalCache;
+use policy_cache::PolicyCache;
 use half::TreeHalf;
 use hash::{HashEntry, HashTable};
 use node::NodeStatsDelta;
@@ -10,6 +18,7 @@ pub use node::{Node, NodePtr};
 
 use std::{
     array,
+    io::{Read, Write},
     mem::MaybeUninit,
     ops::Index,
     ptr,
@@ -17,14 +26,17 @@ use std::{
 };
 
 use crate::{
-    chess::{ChessState, GameState, Move},
+    chess::{Castling, ChessState, GameState, Move, Position},
     mcts::{MctsParams, SearchHelpers},
     networks::PolicyNetwork,
 };
 
 const NUM_SIDES: usize = 2;
+const DEFAULT_EVAL_CACHE_MB: usize = 16;
+const DEFAULT_POLICY_CACHE_MB: usize = 32;
 const NUM_SQUARES: usize = 64;
 const ROOT_ACCUM_THRESHOLD: u64 = 32;
+const ROOT_ACCUM_THRESHOLD_MAX: u64 = 1024;
 const ROOT_ACCUM_EAGER_LIMIT: u64 = 256;
 const NODE_BATCH_THRESHOLD: u64 = 16384;
 const MAX_BATCHED_NODES: usize = 32;
@@ -48,7 +60,7 @@ impl RootAccumulatorEntry {
         }
     }
 
-    fn add(&self, delta: NodeStatsDelta) -> Option<NodeStatsDelta> {
+    fn add(&self, delta: NodeStatsDelta, threshold: u64) -> Option<NodeStatsDelta> {
         if delta.is_empty() {
             return None;
         }
@@ -60,11 +72,14 @@ impl RootAccumulatorEntry {
         self.draws.fetch_add(delta.draws, Ordering::AcqRel);
 
         let new_total = previous_visits.saturating_add(visits_added);
-        if new_total >= ROOT_ACCUM_THRESHOLD {
+        if new_total >= threshold {
             let flush = self.take();
             if flush.is_empty() {
                 None
             } else {
+                #[cfg(feature = "stats")]
+                contention::count(&contention::ACCUM_FLUSHES);
+
                 Some(flush)
             }
         } else {
@@ -98,6 +113,8 @@ impl Default for RootAccumulatorEntry {
 struct RootAccumulator {
     nodes: [AtomicU64; MAX_BATCHED_NODES],
     entries: Vec<[RootAccumulatorEntry; MAX_BATCHED_NODES]>,
+    /// Flush granularity, adapted at runtime by the scheduler.
+    threshold: AtomicU64,
 }
 
 impl RootAccumulator {
@@ -108,7 +125,11 @@ impl RootAccumulator {
             entries.push(array::from_fn(|_| RootAccumulatorEntry::new()));
         }
 
-        Self { nodes, entries }
+        Self {
+            nodes,
+            entries,
+            threshold: AtomicU64::new(ROOT_ACCUM_THRESHOLD),
+        }
     }
 
     fn add(&self, ptr: NodePtr, node: &Node, delta: NodeStatsDelta, thread_id: usize) {
@@ -136,7 +157,9 @@ impl RootAccumulator {
             return;
         }
 
-        if let Some(flush) = self.entries[thread_id][slot].add(delta) {
+        let threshold = self.threshold.load(Ordering::Relaxed);
+
+        if let Some(flush) = self.entries[thread_id][slot].add(delta, threshold) {
             node.apply_delta(flush);
         }
     }
@@ -289,13 +312,74 @@ fn scale_bonus(score: i16, bonus: i32, reduction_factor: i32) -> i16 {
     adjusted.clamp(i16::MIN as i32, i16::MAX as i32) as i16
 }
 
+/// Runtime scheduler for the aggregation knobs: selection collisions
+/// (picking a child another thread is already expanding) are counted, and
+/// the clock thread periodically turns the observed collision rate into an
+/// adapted virtual-loss scale and root-accumulator flush threshold, so one
+/// build behaves sensibly from 8-thread laptops to 128-thread servers.
+/// Counters are per thread (cacheline-padded, like SearchStats) so the
+/// selection hot loop never writes a shared line; only the clock thread
+/// sums them.
+struct SearchScheduler {
+    per_thread: Vec<SchedulerCounters>,
+    vl_scale: atomic_f32::AtomicF32,
+}
+
+#[repr(align(64))]
+#[derive(Default)]
+struct SchedulerCounters {
+    selections: AtomicU64,
+    collisions: AtomicU64,
+}
+
+mod atomic_f32 {
+    use std::sync::atomic::{AtomicU32, Ordering};
+
+    pub struct AtomicF32(AtomicU32);
+
+    impl AtomicF32 {
+        pub fn new(val: f32) -> Self {
+            Self(AtomicU32::new(val.to_bits()))
+        }
+
+        pub fn load(&self) -> f32 {
+            f32::from_bits(self.0.load(Ordering::Relaxed))
+        }
+
+        pub fn store(&self, val: f32) {
+            self.0.store(val.to_bits(), Ordering::Relaxed);
+        }
+    }
+}
+
+impl SearchScheduler {
+    fn new(threads: usize) -> Self {
+        Self {
+            per_thread: (0..threads).map(|_| SchedulerCounters::default()).collect(),
+            vl_scale: atomic_f32::AtomicF32::new(1.0),
+        }
+    }
+
+    fn reset(&self) {
+        for counters in &self.per_thread {
+            counters.selections.store(0, Ordering::Relaxed);
+            counters.collisions.store(0, Ordering::Relaxed);
+        }
+
+        self.vl_scale.store(1.0);
+    }
+}
+
 pub struct Tree {
     root: ChessState,
     tree: [TreeHalf; 2],
     half: AtomicBool,
     hash: HashTable,
+    eval_cache: std::sync::Arc<EvalCache>,
+    policy_cache: PolicyCache,
     butterfly: ButterflyTable,
     root_accumulator: RootAccumulator,
+    scheduler: SearchScheduler,
 }
 
 impl Index<NodePtr> for Tree {
@@ -308,6 +392,18 @@ impl Index<NodePtr> for Tree {
 
 impl Tree {
     pub fn new_mb(mb: usize, threads: usize) -> Self {
+        Self::new_mb_with_caches(mb, threads, DEFAULT_EVAL_CACHE_MB, DEFAULT_POLICY_CACHE_MB)
+    }
+
+    /// As [`new_mb`](Self::new_mb) with explicit cache budgets; a size of
+    /// zero yields an inert cache, for callers that inject a shared one
+    /// (datagen) or want many small trees without the per-tree overhead.
+    pub fn new_mb_with_caches(
+        mb: usize,
+        threads: usize,
+        eval_cache_mb: usize,
+        policy_cache_mb: usize,
+    ) -> Self {
         let bytes = mb * 1024 * 1024;
 
         const _: () = assert!(
@@ -317,10 +413,22 @@ impl Tree {
 
         let node_bytes = std::mem::size_of::<Node>() + 2;
 
-        Self::new(bytes / node_bytes, bytes / node_bytes / 16, threads)
+        Self::new(
+            bytes / node_bytes,
+            bytes / node_bytes / 16,
+            threads,
+            eval_cache_mb,
+            policy_cache_mb,
+        )
     }
 
-    fn new(tree_cap: usize, hash_cap: usize, threads: usize) -> Self {
+    fn new(
+        tree_cap: usize,
+        hash_cap: usize,
+        threads: usize,
+        eval_cache_mb: usize,
+        policy_cache_mb: usize,
+    ) -> Self {
         let tree = Self {
             root: ChessState::default(),
             tree: [
@@ -329,8 +437,11 @@ impl Tree {
             ],
             half: AtomicBool::new(false),
             hash: HashTable::new(hash_cap / 4, threads),
+            eval_cache: std::sync::Arc::new(EvalCache::new_mb(eval_cache_mb)),
+            policy_cache: PolicyCache::new_mb(policy_cache_mb),
             butterfly: ButterflyTable::new(),
             root_accumulator: RootAccumulator::new(threads),
+            scheduler: SearchScheduler::new(threads),
         };
 
         tree.reset_root_accumulator();
@@ -406,7 +517,10 @@ impl Tree {
 
         let old = usize::from(self.half.fetch_xor(true, Ordering::Relaxed));
         self.tree[old ^ 1].clear();
-        self.tree[old].clear_cross_links(self.half.load(Ordering::Relaxed));
+        self.tree[old].clear_cross_links(
+            self.half.load(Ordering::Relaxed),
+            self.root_accumulator.entries.len(),
+        );
 
         if copy_across {
             let new_root_ptr = self.tree[self.half()].reserve_nodes_thread(1, 0).unwrap();
@@ -455,6 +569,28 @@ impl Tree {
         self.hash.push(hash, wins, draw, visits);
     }
 
+    pub fn probe_eval_cache(&self, hash: u64) -> Option<(f32, f32)> {
+        self.eval_cache.get(hash)
+    }
+
+    pub fn push_eval_cache(&self, hash: u64, win: f32, draw: f32) {
+        self.eval_cache.push(hash, win, draw);
+    }
+
+    pub fn prefetch_eval_cache(&self, hash: u64) {
+        self.eval_cache.prefetch(hash);
+    }
+
+    pub fn resize_eval_cache(&mut self, mb: usize) {
+        self.eval_cache = std::sync::Arc::new(EvalCache::new_mb(mb));
+    }
+
+    /// Share one eval cache between several trees (datagen threads), so
+    /// positions repeated across games hit instead of re-evaluating.
+    pub fn use_shared_eval_cache(&mut self, cache: std::sync::Arc<EvalCache>) {
+        self.eval_cache = cache;
+    }
+
     pub fn update_node_stats(&self, ptr: NodePtr, value: f32, draw: f32, thread_id: usize) {
         let delta = NodeStatsDelta::from_value(value, draw);
         self.root_accumulator.add(ptr, &self[ptr], delta, thread_id);
@@ -467,6 +603,10 @@ impl Tree {
 
     fn reset_root_accumulator(&self) {
         self.root_accumulator.reset(self.root_node());
+        self.scheduler.reset();
+        self.root_accumulator
+            .threshold
+            .store(ROOT_ACCUM_THRESHOLD, Ordering::Relaxed);
     }
 
     fn clear_halves(&self) {
@@ -478,6 +618,8 @@ impl Tree {
         self.root = ChessState::default();
         self.clear_halves();
         self.hash.clear(threads);
+        self.eval_cache.clear(threads);
+        self.policy_cache.clear();
         self.butterfly.clear();
         self.root_accumulator.reset(self.root_node());
     }
@@ -511,12 +653,35 @@ impl Tree {
         let mut count = 0;
         let stm = pos.stm();
 
-        pos.map_moves_with_policies(policy, |mov, policy| {
-            let adjusted = policy + self.butterfly.policy_bonus(stm, mov, params);
-            moves[count].write((mov, adjusted));
-            count += 1;
-            max = max.max(adjusted);
-        });
+        // transposed lines (and nodes re-expanded after a half flip) share
+        // the policy network pass through the policy cache; the butterfly
+        // bonus is applied after the cache so entries stay exact
+        let hash = pos.hash();
+        let mut raw = [(Move::NULL, 0.0); policy_cache::MAX_MOVES];
+
+        if let Some(cached) = self.policy_cache.get(hash, &mut raw) {
+            for &(mov, logit) in &raw[..cached] {
+                let adjusted = logit + self.butterfly.policy_bonus(stm, mov, params);
+                moves[count].write((mov, adjusted));
+                count += 1;
+                max = max.max(adjusted);
+            }
+        } else {
+            pos.map_moves_with_policies(policy, |mov, logit| {
+                if count < policy_cache::MAX_MOVES {
+                    raw[count] = (mov, logit);
+                }
+
+                let adjusted = logit + self.butterfly.policy_bonus(stm, mov, params);
+                moves[count].write((mov, adjusted));
+                count += 1;
+                max = max.max(adjusted);
+            });
+
+            if count <= policy_cache::MAX_MOVES {
+                self.policy_cache.push(hash, &raw[..count]);
+            }
+        }
 
         let new_ptr = self.tree[self.half()].reserve_nodes_thread(count, thread_id)?;
 
@@ -568,16 +733,18 @@ impl Tree {
 
         let hl = pos.get_policy_hl(policy);
         let mut max = f32::NEG_INFINITY;
-        let mut policies = Vec::new();
 
         let stm = pos.stm();
-        for action in 0..num_actions {
-            let mov = self[actions_ptr + action].parent_move();
-            let policy =
-                pos.get_policy(mov, &hl, policy) + self.butterfly.policy_bonus(stm, mov, params);
+        let moves: Vec<Move> = (0..num_actions)
+            .map(|action| self[actions_ptr + action].parent_move())
+            .collect();
+
+        let mut policies = vec![0.0; num_actions];
+        pos.get_policies(policy, &moves, &hl, &mut policies);
 
-            policies.push(policy);
-            max = max.max(policy);
+        for (policy, &mov) in policies.iter_mut().zip(moves.iter()) {
+            *policy += self.butterfly.policy_bonus(stm, mov, params);
+            max = max.max(*policy);
         }
 
         let pst = SearchHelpers::get_pst(depth.into(), self[node_ptr].q(), params);
@@ -647,6 +814,8 @@ impl Tree {
         let old_root = self.root.clone();
         self.root = new_root.clone();
 
+        self.eval_cache.age_up();
+
         self.flush_root_accumulator();
         self.reset_root_accumulator();
 
@@ -716,6 +885,231 @@ impl Tree {
         NodePtr::NULL
     }
 
+    /// Snapshot the tree (both node arenas, the hash table and the root
+    /// position) into a raw-layout file so an analysis session can resume
+    /// without recomputation. NodePtr's half+index encoding is position
+    /// independent, so the node bytes are written verbatim.
+    pub fn save(&self, path: &str) -> std::io::Result<()> {
+        const MAGIC: u64 = 0x4d4f4e5459545245;
+
+        self.flush_root_accumulator();
+
+        let mut out = std::io::BufWriter::new(std::fs::File::create(path)?);
+
+        out.write_all(&MAGIC.to_le_bytes())?;
+        out.write_all(&(std::mem::size_of::<Node>() as u64).to_le_bytes())?;
+        out.write_all(&(std::mem::size_of::<Position>() as u64).to_le_bytes())?;
+        out.write_all(&(u64::from(self.half.load(Ordering::Relaxed))).to_le_bytes())?;
+        out.write_all(&(self.tree[0].capacity() as u64).to_le_bytes())?;
+        out.write_all(&(self.hash.len() as u64).to_le_bytes())?;
+        out.write_all(&(self.root_accumulator.entries.len() as u64).to_le_bytes())?;
+
+        let board = self.root.board();
+        let castling = self.root.castling();
+        out.write_all(raw_bytes(&board))?;
+        out.write_all(raw_bytes(&castling))?;
+
+        for half in &self.tree {
+            out.write_all(&(half.used() as u64).to_le_bytes())?;
+            out.write_all(half.node_bytes())?;
+        }
+
+        out.write_all(self.hash.as_bytes())?;
+        out.flush()
+    }
+
+    /// Load a snapshot written by [`Tree::save`], rebuilding the tree at the
+    /// snapshot's capacities and re-registering the cross-half links with a
+    /// linear scan over the restored nodes.
+    pub fn load(path: &str, threads: usize) -> std::io::Result<Self> {
+        const MAGIC: u64 = 0x4d4f4e5459545245;
+
+        let bad = |msg: &str| std::io::Error::new(std::io::ErrorKind::InvalidData, msg);
+
+        let mut file = std::io::BufReader::new(std::fs::File::open(path)?);
+
+        let mut word = [0u8; 8];
+        let mut read_u64 = |file: &mut std::io::BufReader<std::fs::File>| -> std::io::Result<u64> {
+            file.read_exact(&mut word)?;
+            Ok(u64::from_le_bytes(word))
+        };
+
+        if read_u64(&mut file)? != MAGIC {
+            return Err(bad("not a monty tree snapshot"));
+        }
+
+        if read_u64(&mut file)? != std::mem::size_of::<Node>() as u64
+            || read_u64(&mut file)? != std::mem::size_of::<Position>() as u64
+        {
+            return Err(bad("snapshot written by an incompatible build"));
+        }
+
+        let half = read_u64(&mut file)? != 0;
+        let half_cap = read_u64(&mut file)? as usize;
+        let hash_cap = read_u64(&mut file)? as usize;
+        let _saved_threads = read_u64(&mut file)? as usize;
+
+        let mut board = Position::default();
+        let mut castling = Castling::default();
+        file.read_exact(raw_bytes_mut(&mut board))?;
+        file.read_exact(raw_bytes_mut(&mut castling))?;
+
+        let mut tree = Self::new(
+            half_cap * 2,
+            hash_cap * 4,
+            threads,
+            DEFAULT_EVAL_CACHE_MB,
+            DEFAULT_POLICY_CACHE_MB,
+        );
+        tree.root = ChessState::from_raw(board, castling);
+        tree.half.store(half, Ordering::Relaxed);
+
+        for half in &mut tree.tree {
+            let mut used_word = [0u8; 8];
+            file.read_exact(&mut used_word)?;
+            let used = u64::from_le_bytes(used_word) as usize;
+
+            if used > half.capacity() {
+                return Err(bad("snapshot arena larger than stated capacity"));
+            }
+
+            let mut bytes = vec![0u8; used * std::mem::size_of::<Node>()];
+            file.read_exact(&mut bytes)?;
+            half.restore_node_bytes(&bytes, used);
+        }
+
+        let mut hash_bytes = vec![0u8; tree.hash.as_bytes().len()];
+        file.read_exact(&mut hash_bytes)?;
+        tree.hash.write_bytes(&hash_bytes);
+
+        // re-register cross-half links so future flips repair them
+        for half_idx in 0..2 {
+            let this_half = half_idx == 1;
+
+            for idx in 0..tree.tree[half_idx].used().min(tree.tree[half_idx].capacity()) {
+                let ptr = NodePtr::new(this_half, idx);
+                let actions = tree[ptr].actions();
+
+                if !actions.is_null() && actions.half() != this_half {
+                    tree.tree[half_idx].register_cross_link(ptr, actions);
+                }
+            }
+        }
+
+        tree.reset_root_accumulator();
+
+        Ok(tree)
+    }
+
+    /// Fill `buf` with the current root-child visit counts, saturated to
+    /// i32, reusing the buffer's allocation across calls.
+    pub fn root_visit_distribution_into(&self, buf: &mut Vec<i32>) {
+        buf.clear();
+
+        let root = self.root_node();
+        let first = self[root].actions();
+
+        for action in 0..self[root].num_actions() {
+            let v = self[first + action].visits();
+            buf.push((v as i64).min(i32::MAX as i64) as i32);
+        }
+    }
+
+    /// Visit/q/draw totals for every root child, for shipping to a
+    /// coordinator in distributed root-parallel mode.
+    pub fn root_child_stats(&self) -> Vec<(Move, u64, f32, f32)> {
+        let root = self.root_node();
+        let first = self[root].actions();
+
+        (0..self[root].num_actions())
+            .map(|action| {
+                let child = &self[first + action];
+                (child.parent_move(), child.visits(), child.q(), child.draw())
+            })
+            .collect()
+    }
+
+    /// Fold a remote worker's totals for one root move into the local root
+    /// distribution. Returns false if no root child plays that move.
+    pub fn merge_root_child(
+        &self,
+        mov: &str,
+        pos: &ChessState,
+        visits: u64,
+        q: f32,
+        draw: f32,
+    ) -> bool {
+        let root = self.root_node();
+        let first = self[root].actions();
+
+        for action in 0..self[root].num_actions() {
+            let ptr = first + action;
+
+            if pos.conv_mov_to_str(self[ptr].parent_move()) == mov {
+                self[ptr].apply_delta(NodeStatsDelta::from_totals(visits, q, draw));
+                return true;
+            }
+        }
+
+        false
+    }
+
+    /// Record one PUCT selection; `collided` when the chosen child was
+    /// already being worked on by another thread. Writes only this thread's
+    /// padded counter line.
+    pub fn note_selection(&self, thread_id: usize, collided: bool) {
+        let Some(counters) = self.scheduler.per_thread.get(thread_id) else {
+            return;
+        };
+
+        counters.selections.fetch_add(1, Ordering::Relaxed);
+
+        if collided {
+            counters.collisions.fetch_add(1, Ordering::Relaxed);
+        }
+    }
+
+    /// Scale applied on top of the virtual-loss weight parameter.
+    pub fn virtual_loss_scale(&self) -> f32 {
+        self.scheduler.vl_scale.load()
+    }
+
+    /// Re-derive the aggregation knobs from the collision rate observed
+    /// since the last call; invoked periodically from the clock thread.
+    pub fn adapt_scheduler(&self) {
+        let mut selections = 0;
+        let mut collisions = 0;
+
+        for counters in &self.scheduler.per_thread {
+            selections += counters.selections.swap(0, Ordering::Relaxed);
+            collisions += counters.collisions.swap(0, Ordering::Relaxed);
+        }
+
+        if selections < 1024 {
+            return;
+        }
+
+        let rate = collisions as f64 / selections as f64;
+        let scale = self.scheduler.vl_scale.load();
+        let threshold = self.root_accumulator.threshold.load(Ordering::Relaxed);
+
+        if rate > 0.05 {
+            // heavy collisions: push threads apart harder and batch more
+            self.scheduler.vl_scale.store((scale * 1.25).min(4.0));
+            self.root_accumulator.threshold.store(
+                (threshold * 2).min(ROOT_ACCUM_THRESHOLD_MAX),
+                Ordering::Relaxed,
+            );
+        } else if rate < 0.01 {
+            // contention has subsided: decay back towards the defaults
+            self.scheduler.vl_scale.store((scale / 1.25).max(1.0));
+            self.root_accumulator.threshold.store(
+                (threshold / 2).max(ROOT_ACCUM_THRESHOLD),
+                Ordering::Relaxed,
+            );
+        }
+    }
+
     pub fn get_best_child(&self, ptr: NodePtr) -> usize {
         self.get_best_child_by_key(ptr, |n| n.visits() as f32)
     }
@@ -821,3 +1215,11 @@ impl Tree {
         }
     }
 }
+
+fn raw_bytes<T>(val: &T) -> &[u8] {
+    unsafe { std::slice::from_raw_parts((val as *const T).cast(), std::mem::size_of::<T>()) }
+}
+
+fn raw_bytes_mut<T>(val: &mut T) -> &mut [u8] {
+    unsafe { std::slice::from_raw_parts_mut((val as *mut T).cast(), std::mem::size_of::<T>()) }
+}
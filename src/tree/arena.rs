@@ -0,0 +1,118 @@
+use std::sync::atomic::AtomicBool;
+
+use memmap2::MmapMut;
+
+use super::Node;
+
+/// Whether tree arenas should request huge pages; toggled by the UCI
+/// `HugePages` option before the tree is rebuilt.
+pub static HUGE_PAGES: AtomicBool = AtomicBool::new(true);
+
+const HUGE_PAGE_BITS: u8 = 21;
+const HUGE_PAGE_SIZE: usize = 1 << HUGE_PAGE_BITS;
+
+/// Anonymous-mapping-backed node arena for a tree half.
+///
+/// Large trees are dominated by TLB pressure on 4 KB pages, so the arena
+/// tries explicit 2 MB huge pages first, falls back to a transparent-huge-
+/// page madvise, and finally to plain pages; allocation never fails on
+/// machines without reserved huge pages. Pages are mapped zeroed and
+/// first-touched by the parallel initialisation in `TreeHalf::new`, so the
+/// faulting thread determines page placement.
+pub struct NodeArena {
+    mmap: Option<MmapMut>,
+    len: usize,
+}
+
+unsafe impl Send for NodeArena {}
+unsafe impl Sync for NodeArena {}
+
+impl NodeArena {
+    pub fn new(len: usize) -> Self {
+        let bytes = len * std::mem::size_of::<Node>();
+
+        if bytes == 0 {
+            return Self { mmap: None, len };
+        }
+
+        let huge = HUGE_PAGES.load(std::sync::atomic::Ordering::Relaxed);
+
+        #[cfg(target_os = "linux")]
+        if huge && bytes >= HUGE_PAGE_SIZE {
+            // explicit huge pages need a length rounded to the page size,
+            // and fail cleanly when none are reserved on the host
+            let rounded = bytes.next_multiple_of(HUGE_PAGE_SIZE);
+
+            if let Ok(mmap) = memmap2::MmapOptions::new()
+                .len(rounded)
+                .huge(Some(HUGE_PAGE_BITS))
+                .map_anon()
+            {
+                return Self {
+                    mmap: Some(mmap),
+                    len,
+                };
+            }
+        }
+
+        let mmap = MmapMut::map_anon(bytes).expect("failed to allocate tree arena");
+
+        #[cfg(target_os = "linux")]
+        if huge {
+            // best effort: let the kernel back this range with THP
+            let _ = mmap.advise(memmap2::Advice::HugePage);
+        }
+
+        Self {
+            mmap: Some(mmap),
+            len,
+        }
+    }
+
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    pub fn as_mut_ptr(&mut self) -> *mut Node {
+        match &mut self.mmap {
+            Some(mmap) => mmap.as_mut_ptr().cast(),
+            None => std::ptr::NonNull::dangling().as_ptr(),
+        }
+    }
+
+    pub fn used_bytes(&self, count: usize) -> &[u8] {
+        let slice = &self.as_slice()[..count];
+        unsafe {
+            std::slice::from_raw_parts(
+                slice.as_ptr().cast(),
+                count * std::mem::size_of::<Node>(),
+            )
+        }
+    }
+
+    pub fn write_used_bytes(&mut self, bytes: &[u8]) {
+        assert!(bytes.len() <= self.len * std::mem::size_of::<Node>());
+        assert_eq!(bytes.len() % std::mem::size_of::<Node>(), 0);
+
+        unsafe {
+            std::ptr::copy_nonoverlapping(bytes.as_ptr(), self.as_mut_ptr().cast(), bytes.len());
+        }
+    }
+
+    fn as_slice(&self) -> &[Node] {
+        match &self.mmap {
+            Some(mmap) => unsafe {
+                std::slice::from_raw_parts(mmap.as_ptr().cast(), self.len)
+            },
+            None => &[],
+        }
+    }
+}
+
+impl std::ops::Index<usize> for NodeArena {
+    type Output = Node;
+
+    fn index(&self, index: usize) -> &Self::Output {
+        &self.as_slice()[index]
+    }
+}
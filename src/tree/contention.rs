@@ -0,0 +1,35 @@
+//! Contention counters behind the `stats` feature.
+//!
+//! Counters are global relaxed atomics rather than per-thread arrays because
+//! the hottest sites (`CustomLock`) have no thread identity available; the
+//! totals are what distinguishes lock spin from accumulator flushes from
+//! arena reservation when thread scaling flatlines.
+
+use std::sync::atomic::{AtomicU64, Ordering};
+
+pub static LOCK_SPINS: AtomicU64 = AtomicU64::new(0);
+pub static LOCK_CAS_FAILS: AtomicU64 = AtomicU64::new(0);
+pub static ACCUM_FLUSHES: AtomicU64 = AtomicU64::new(0);
+pub static RESERVE_BLOCKS: AtomicU64 = AtomicU64::new(0);
+pub static RESERVE_FAILS: AtomicU64 = AtomicU64::new(0);
+
+#[inline]
+pub fn count(counter: &AtomicU64) {
+    counter.fetch_add(1, Ordering::Relaxed);
+}
+
+pub fn reset() {
+    LOCK_SPINS.store(0, Ordering::Relaxed);
+    LOCK_CAS_FAILS.store(0, Ordering::Relaxed);
+    ACCUM_FLUSHES.store(0, Ordering::Relaxed);
+    RESERVE_BLOCKS.store(0, Ordering::Relaxed);
+    RESERVE_FAILS.store(0, Ordering::Relaxed);
+}
+
+pub fn report() {
+    println!("lock spins:         {}", LOCK_SPINS.load(Ordering::Relaxed));
+    println!("lock cas fails:     {}", LOCK_CAS_FAILS.load(Ordering::Relaxed));
+    println!("accumulator flushes: {}", ACCUM_FLUSHES.load(Ordering::Relaxed));
+    println!("reserved blocks:    {}", RESERVE_BLOCKS.load(Ordering::Relaxed));
+    println!("reserve failures:   {}", RESERVE_FAILS.load(Ordering::Relaxed));
+}
@@ -0,0 +1,158 @@
+use std::sync::atomic::{AtomicU32, Ordering};
+
+const WAYS: usize = 4;
+
+/// A bucket of ways sharing one index, sized to a cache line.
+#[derive(Default)]
+#[repr(align(64))]
+struct EvalCacheBucket {
+    entries: [EvalCacheEntryInternal; WAYS],
+}
+
+#[derive(Default)]
+struct EvalCacheEntryInternal {
+    key: AtomicU32,
+    win: AtomicU32,
+    draw: AtomicU32,
+    age: AtomicU32,
+}
+
+/// A set-associative, lock-free cache of raw value-network outputs, keyed by
+/// position hash and sized independently of the tree hash table. Entries
+/// store the network's win/draw probabilities bit-exactly, so a hit
+/// reproduces `ValueNetwork::eval` for free; replacement evicts the way
+/// least recently touched relative to a per-search epoch.
+pub struct EvalCache {
+    buckets: Vec<EvalCacheBucket>,
+    epoch: AtomicU32,
+}
+
+impl EvalCache {
+    /// A size of zero is valid and yields an inert cache (used when a
+    /// shared cache will be injected instead).
+    pub fn new_mb(mb: usize) -> Self {
+        let buckets = (mb * 1024 * 1024) / std::mem::size_of::<EvalCacheBucket>();
+
+        let mut cache = EvalCache {
+            buckets: Vec::new(),
+            epoch: AtomicU32::new(1),
+        };
+        cache.buckets.resize_with(buckets, EvalCacheBucket::default);
+
+        cache
+    }
+
+    fn key(hash: u64) -> u32 {
+        (hash >> 32) as u32
+    }
+
+    fn bucket(&self, hash: u64) -> &EvalCacheBucket {
+        let idx = hash % (self.buckets.len() as u64);
+        &self.buckets[idx as usize]
+    }
+
+    /// Bumped once per search so replacement can prefer entries from older
+    /// searches; cached values themselves never go stale as the network is
+    /// fixed for the lifetime of the process.
+    pub fn age_up(&self) {
+        self.epoch.fetch_add(1, Ordering::Relaxed);
+    }
+
+    pub fn clear(&self, threads: usize) {
+        if self.buckets.is_empty() {
+            return;
+        }
+
+        let chunk_size = self.buckets.len().div_ceil(threads);
+
+        std::thread::scope(|s| {
+            for chunk in self.buckets.chunks(chunk_size) {
+                s.spawn(move || {
+                    for bucket in chunk {
+                        for entry in &bucket.entries {
+                            entry.key.store(0, Ordering::Relaxed);
+                            entry.win.store(0, Ordering::Relaxed);
+                            entry.draw.store(0, Ordering::Relaxed);
+                            entry.age.store(0, Ordering::Relaxed);
+                        }
+                    }
+                });
+            }
+        });
+
+        self.epoch.store(1, Ordering::Relaxed);
+    }
+
+    /// Hint the bucket for `hash` into cache ahead of a likely probe.
+    pub fn prefetch(&self, hash: u64) {
+        if self.buckets.is_empty() {
+            return;
+        }
+
+        #[cfg(target_arch = "x86_64")]
+        unsafe {
+            use std::arch::x86_64::{_mm_prefetch, _MM_HINT_T0};
+            let bucket: *const EvalCacheBucket = self.bucket(hash);
+            _mm_prefetch(bucket.cast(), _MM_HINT_T0);
+        }
+
+        #[cfg(not(target_arch = "x86_64"))]
+        let _ = hash;
+    }
+
+    pub fn get(&self, hash: u64) -> Option<(f32, f32)> {
+        if self.buckets.is_empty() {
+            return None;
+        }
+
+        let key = Self::key(hash);
+        let epoch = self.epoch.load(Ordering::Relaxed);
+
+        for entry in &self.bucket(hash).entries {
+            if entry.key.load(Ordering::Relaxed) == key {
+                entry.age.store(epoch, Ordering::Relaxed);
+
+                let win = f32::from_bits(entry.win.load(Ordering::Relaxed));
+                let draw = f32::from_bits(entry.draw.load(Ordering::Relaxed));
+
+                return Some((win, draw));
+            }
+        }
+
+        None
+    }
+
+    pub fn push(&self, hash: u64, win: f32, draw: f32) {
+        if self.buckets.is_empty() {
+            return;
+        }
+
+        let key = Self::key(hash);
+        let epoch = self.epoch.load(Ordering::Relaxed);
+        let bucket = self.bucket(hash);
+
+        let mut victim = &bucket.entries[0];
+        let mut victim_age = u32::MAX;
+
+        for entry in &bucket.entries {
+            let entry_key = entry.key.load(Ordering::Relaxed);
+
+            if entry_key == key {
+                victim = entry;
+                break;
+            }
+
+            let age = entry.age.load(Ordering::Relaxed);
+
+            if age < victim_age {
+                victim_age = age;
+                victim = entry;
+            }
+        }
+
+        victim.win.store(win.to_bits(), Ordering::Relaxed);
+        victim.draw.store(draw.to_bits(), Ordering::Relaxed);
+        victim.age.store(epoch, Ordering::Relaxed);
+        victim.key.store(key, Ordering::Relaxed);
+    }
+}
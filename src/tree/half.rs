@@ -3,13 +3,13 @@ use std::sync::{
     Mutex,
 };
 
-use super::{Node, NodePtr};
+use super::{arena::NodeArena, Node, NodePtr};
 use crate::chess::GameState;
 
 const CACHE_SIZE: usize = 1024;
 
 pub struct TreeHalf {
-    pub(super) nodes: Vec<Node>,
+    pub(super) nodes: NodeArena,
     used: AtomicUsize,
     next: Vec<AtomicUsize>,
     end: Vec<AtomicUsize>,
@@ -33,7 +33,7 @@ impl TreeHalf {
         let cross_link_marks = (0..size).map(|_| AtomicU64::new(0)).collect();
 
         let mut res = Self {
-            nodes: Vec::new(),
+            nodes: NodeArena::new(size),
             used: AtomicUsize::new(0),
             next: (0..threads).map(|_| AtomicUsize::new(0)).collect(),
             end: (0..threads).map(|_| AtomicUsize::new(0)).collect(),
@@ -43,14 +43,14 @@ impl TreeHalf {
             cross_link_epoch: AtomicU64::new(1),
         };
 
-        res.nodes.reserve_exact(size);
-
         unsafe {
             use std::mem::MaybeUninit;
             let chunk_size = size.div_ceil(threads);
             let ptr = res.nodes.as_mut_ptr().cast();
             let uninit: &mut [MaybeUninit<Node>] = std::slice::from_raw_parts_mut(ptr, size);
 
+            // first touch happens here, on the initialising threads, which
+            // also determines the page placement of the freshly mapped arena
             std::thread::scope(|s| {
                 for chunk in uninit.chunks_mut(chunk_size) {
                     s.spawn(|| {
@@ -60,8 +60,6 @@ impl TreeHalf {
                     });
                 }
             });
-
-            res.nodes.set_len(size);
         }
 
         res
@@ -72,9 +70,15 @@ impl TreeHalf {
         let mut end = self.end[thread].load(Ordering::Relaxed);
 
         if next + num > end {
+            #[cfg(feature = "stats")]
+            super::contention::count(&super::contention::RESERVE_BLOCKS);
+
             let block = CACHE_SIZE.max(num);
             let start = self.used.fetch_add(block, Ordering::Relaxed);
             if start + block > self.nodes.len() {
+                #[cfg(feature = "stats")]
+                super::contention::count(&super::contention::RESERVE_FAILS);
+
                 return None;
             }
             next = start;
@@ -99,45 +103,82 @@ impl TreeHalf {
         self.cross_links.lock().unwrap().clear();
     }
 
-    pub fn clear_cross_links(&self, target_half: bool) {
+    pub fn clear_cross_links(&self, target_half: bool, threads: usize) {
         let epoch = self.cross_link_epoch.load(Ordering::Relaxed);
-        let mut links = self.cross_links.lock().unwrap();
-        let mut idx = 0;
-        let mut to_clear = Vec::new();
-
-        while idx < links.len() {
-            let node_idx = links[idx];
-            if self.cross_link_marks[node_idx].load(Ordering::Relaxed) != epoch {
-                links.swap_remove(idx);
-                continue;
-            }
+        let links = std::mem::take(&mut *self.cross_links.lock().unwrap());
+
+        if links.is_empty() {
+            return;
+        }
+
+        // the repair scan is the dominant part of the flip stall on big
+        // trees, so fan it out over the configured thread count; search is
+        // quiesced while flipping, so the workers own their chunks outright
+        let chunk_size = links.len().div_ceil(threads.max(1));
+        let survivors = Mutex::new(Vec::with_capacity(links.len()));
+        let survivors = &survivors;
+
+        std::thread::scope(|s| {
+            for chunk in links.chunks(chunk_size) {
+                s.spawn(move || {
+                    let mut keep = Vec::new();
+
+                    for &node_idx in chunk {
+                        if self.cross_link_marks[node_idx].load(Ordering::Relaxed) != epoch {
+                            continue;
+                        }
 
-            let node_ptr = NodePtr::new(self.half, node_idx);
-            let actions = self[node_ptr].actions();
+                        let node_ptr = NodePtr::new(self.half, node_idx);
+                        let actions = self[node_ptr].actions();
 
-            if actions.is_null() || actions.half() == self.half {
-                self.cross_link_marks[node_idx].store(0, Ordering::Relaxed);
-                links.swap_remove(idx);
-                continue;
-            }
+                        if actions.is_null() || actions.half() == self.half {
+                            self.cross_link_marks[node_idx].store(0, Ordering::Relaxed);
+                            continue;
+                        }
 
-            if actions.half() != target_half {
-                idx += 1;
-                continue;
+                        if actions.half() != target_half {
+                            keep.push(node_idx);
+                            continue;
+                        }
+
+                        self.cross_link_marks[node_idx].store(0, Ordering::Relaxed);
+                        self[node_ptr].clear_actions();
+                    }
+
+                    if !keep.is_empty() {
+                        survivors.lock().unwrap().append(&mut keep);
+                    }
+                });
             }
+        });
 
-            self.cross_link_marks[node_idx].store(0, Ordering::Relaxed);
-            to_clear.push(node_ptr);
-            links.swap_remove(idx);
-        }
+        let survivors = std::mem::take(&mut *survivors.lock().unwrap());
+        *self.cross_links.lock().unwrap() = survivors;
+    }
+
+    pub fn node_bytes(&self) -> &[u8] {
+        self.nodes.used_bytes(self.used().min(self.nodes.len()))
+    }
 
-        drop(links);
+    /// Restore the arena contents and the global allocation watermark from a
+    /// snapshot. Per-thread reservation blocks are deliberately left empty:
+    /// the unconsumed block remainders from the saving process are simply
+    /// never handed out again, which keeps the format independent of the
+    /// thread count.
+    pub fn restore_node_bytes(&mut self, bytes: &[u8], used: usize) {
+        self.nodes.write_used_bytes(bytes);
+        self.used.store(used, Ordering::Relaxed);
 
-        for node_ptr in to_clear {
-            self[node_ptr].clear_actions();
+        for (n, e) in self.next.iter().zip(&self.end) {
+            n.store(0, Ordering::Relaxed);
+            e.store(0, Ordering::Relaxed);
         }
     }
 
+    pub fn capacity(&self) -> usize {
+        self.nodes.len()
+    }
+
     pub fn is_empty(&self) -> bool {
         self.used.load(Ordering::Relaxed) == 0
     }
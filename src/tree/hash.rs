@@ -64,6 +64,34 @@ impl HashTable {
         });
     }
 
+    pub fn len(&self) -> usize {
+        self.table.len()
+    }
+
+    pub fn as_bytes(&self) -> &[u8] {
+        unsafe {
+            std::slice::from_raw_parts(
+                self.table.as_ptr().cast(),
+                self.table.len() * std::mem::size_of::<HashEntryInternal>(),
+            )
+        }
+    }
+
+    pub fn write_bytes(&mut self, bytes: &[u8]) {
+        assert_eq!(
+            bytes.len(),
+            self.table.len() * std::mem::size_of::<HashEntryInternal>()
+        );
+
+        unsafe {
+            std::ptr::copy_nonoverlapping(
+                bytes.as_ptr(),
+                self.table.as_mut_ptr().cast(),
+                bytes.len(),
+            );
+        }
+    }
+
     pub fn fetch(&self, hash: u64) -> HashEntry {
         let idx = hash % (self.table.len() as u64);
         let entry = &self.table[idx as usize];
@@ -43,6 +43,9 @@ impl CustomLock {
     pub fn read(&self) -> NodePtr {
         // spin until no writer holds the lock
         while self.write_locked.load(Ordering::Acquire) {
+            #[cfg(feature = "stats")]
+            super::contention::count(&super::contention::LOCK_SPINS);
+
             std::hint::spin_loop();
         }
 
@@ -55,6 +58,9 @@ impl CustomLock {
             .compare_exchange(false, true, Ordering::Acquire, Ordering::Relaxed)
             .is_err()
         {
+            #[cfg(feature = "stats")]
+            super::contention::count(&super::contention::LOCK_CAS_FAILS);
+
             std::hint::spin_loop();
         }
 
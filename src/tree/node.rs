@@ -79,6 +79,21 @@ impl NodeStatsDelta {
     pub fn is_empty(&self) -> bool {
         self.visits == 0 && self.sum_q == 0 && self.sum_sq_q == 0 && self.draws == 0
     }
+
+    /// Reconstruct a delta from aggregate totals (e.g. shipped over the
+    /// network by a remote worker), approximating the per-visit q spread
+    /// by the mean.
+    pub fn from_totals(visits: u64, q: f32, draw: f32) -> Self {
+        let q = (f64::from(q.clamp(0.0, 1.0)) * f64::from(QUANT)) as u64;
+        let draws = (f64::from(draw.clamp(0.0, 1.0)) * f64::from(QUANT)) as u64;
+
+        Self {
+            visits,
+            sum_q: q * visits,
+            sum_sq_q: q * q * visits,
+            draws: draws * visits,
+        }
+    }
 }
 
 impl AddAssign for NodeStatsDelta {
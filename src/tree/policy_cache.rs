@@ -0,0 +1,140 @@
+use std::sync::atomic::{AtomicU32, AtomicU64, Ordering};
+
+use crate::chess::Move;
+
+/// Upper bound on legal moves in a position (218 is the known maximum).
+pub const MAX_MOVES: usize = 224;
+
+/// A direct-mapped, lock-free cache of raw policy logits keyed by position
+/// hash. A hit reproduces the full hidden-layer pass and per-move scoring
+/// bit-exactly, so transposed lines (and nodes re-expanded after a half
+/// flip) share the policy network work instead of repeating it. Entries
+/// are multi-word, so a seqlock version guards each one: writers skip the
+/// entry if contended, readers discard torn snapshots.
+pub struct PolicyCache {
+    entries: Vec<PolicyCacheEntryInternal>,
+}
+
+struct PolicyCacheEntryInternal {
+    version: AtomicU32,
+    key: AtomicU32,
+    count: AtomicU32,
+    // move in the low 16 bits, logit bits in the upper 32
+    data: [AtomicU64; MAX_MOVES],
+}
+
+impl Default for PolicyCacheEntryInternal {
+    fn default() -> Self {
+        Self {
+            version: AtomicU32::new(0),
+            key: AtomicU32::new(0),
+            count: AtomicU32::new(0),
+            data: std::array::from_fn(|_| AtomicU64::new(0)),
+        }
+    }
+}
+
+fn pack(mov: Move, logit: f32) -> u64 {
+    u64::from(u16::from(mov)) | (u64::from(logit.to_bits()) << 32)
+}
+
+fn unpack(word: u64) -> (Move, f32) {
+    (
+        Move::from(word as u16),
+        f32::from_bits((word >> 32) as u32),
+    )
+}
+
+impl PolicyCache {
+    /// A size of zero is valid and yields an inert cache.
+    pub fn new_mb(mb: usize) -> Self {
+        let entries = (mb * 1024 * 1024) / std::mem::size_of::<PolicyCacheEntryInternal>();
+
+        let mut cache = PolicyCache {
+            entries: Vec::new(),
+        };
+        cache
+            .entries
+            .resize_with(entries, PolicyCacheEntryInternal::default);
+
+        cache
+    }
+
+    fn key(hash: u64) -> u32 {
+        (hash >> 32) as u32
+    }
+
+    fn entry(&self, hash: u64) -> &PolicyCacheEntryInternal {
+        let idx = hash % (self.entries.len() as u64);
+        &self.entries[idx as usize]
+    }
+
+    pub fn clear(&mut self) {
+        for entry in &mut self.entries {
+            *entry = PolicyCacheEntryInternal::default();
+        }
+    }
+
+    pub fn get(&self, hash: u64, out: &mut [(Move, f32); MAX_MOVES]) -> Option<usize> {
+        if self.entries.is_empty() {
+            return None;
+        }
+
+        let entry = self.entry(hash);
+
+        let v1 = entry.version.load(Ordering::Acquire);
+
+        if v1 & 1 == 1 || entry.key.load(Ordering::Relaxed) != Self::key(hash) {
+            return None;
+        }
+
+        let count = entry.count.load(Ordering::Relaxed) as usize;
+
+        // a zero count can only be the default never-written entry matching
+        // a hash with zero upper bits: positions with no legal moves are
+        // terminal and never expanded, so no real entry stores zero moves
+        if count == 0 || count > MAX_MOVES {
+            return None;
+        }
+
+        for (slot, word) in out[..count].iter_mut().zip(entry.data[..count].iter()) {
+            *slot = unpack(word.load(Ordering::Relaxed));
+        }
+
+        // a torn snapshot shows up as a version change; treat it as a miss
+        if entry.version.load(Ordering::Acquire) == v1 {
+            Some(count)
+        } else {
+            None
+        }
+    }
+
+    pub fn push(&self, hash: u64, moves: &[(Move, f32)]) {
+        if moves.len() > MAX_MOVES || self.entries.is_empty() {
+            return;
+        }
+
+        let entry = self.entry(hash);
+
+        let v = entry.version.load(Ordering::Relaxed);
+
+        // another thread is mid-write: skip rather than contend
+        if v & 1 == 1
+            || entry
+                .version
+                .compare_exchange(v, v + 1, Ordering::Acquire, Ordering::Relaxed)
+                .is_err()
+        {
+            return;
+        }
+
+        entry.key.store(Self::key(hash), Ordering::Relaxed);
+        entry.count.store(moves.len() as u32, Ordering::Relaxed);
+
+        for (word, &(mov, logit)) in entry.data.iter().zip(moves.iter()) {
+            word.store(pack(mov, logit), Ordering::Relaxed);
+        }
+
+        entry.version.store(v + 2, Ordering::Release);
+    }
+}
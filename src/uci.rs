@@ -2,7 +2,7 @@ use crate::{
     chess::{ChessState, Move},
     mcts::{Limits, MctsParams, SearchHelpers, Searcher, REPORT_ITERS},
     networks::{PolicyNetwork, ValueNetwork},
-    tree::Tree,
+    tree::{Tree, HUGE_PAGES},
 };
 
 use std::{
@@ -16,6 +16,7 @@ pub fn run(policy: &PolicyNetwork, value: &ValueNetwork, tcec_mode: bool) {
     let mut root_game_ply = 0;
     let mut params = MctsParams::default();
     let mut hash_mb = 64;
+    let mut eval_cache_mb = 16;
     let mut tree = Tree::new_mb(hash_mb, 1);
     let mut report_moves = false;
     let mut threads = 1;
@@ -58,6 +59,7 @@ pub fn run(policy: &PolicyNetwork, value: &ValueNetwork, tcec_mode: bool) {
                 &mut threads,
                 &mut move_overhead,
                 &mut hash_mb,
+                &mut eval_cache_mb,
                 &mut multipv,
                 &mut gui_compatibility,
                 &mut uci_opponent_rating,
@@ -89,16 +91,61 @@ pub fn run(policy: &PolicyNetwork, value: &ValueNetwork, tcec_mode: bool) {
                     1.0,
                 );
             }
-            "bench" => {
-                let depth = if let Some(d) = commands.get(1) {
-                    d.parse().unwrap_or(ChessState::BENCH_DEPTH)
-                } else {
-                    ChessState::BENCH_DEPTH
-                };
+            "bench" => match commands.get(1).copied() {
+                Some("suite") | Some("value") | Some("policy") | Some("tree") => {
+                    bench_suite(&commands, policy, value, &params);
+                }
+                d => {
+                    let depth = d
+                        .and_then(|d| d.parse().ok())
+                        .unwrap_or(ChessState::BENCH_DEPTH);
 
-                bench(depth, policy, value, &params);
+                    bench(depth, policy, value, &params);
+                }
+            },
+            "perft" => run_perft(&commands, &pos, threads, hash_mb),
+            "batchanalyse" => {
+                batchanalyse(&commands, &mut tree, &params, policy, value, threads);
+            }
+            "distgo" => {
+                if commands.len() >= 3 {
+                    let movetime = commands[1].parse().unwrap_or(1000);
+                    crate::distributed::coordinate(
+                        &commands[2..],
+                        movetime,
+                        &mut tree,
+                        &pos,
+                        &params,
+                        policy,
+                        value,
+                        threads,
+                    );
+                } else {
+                    println!("info string usage: distgo <movetime> <addr> [<addr>...]");
+                }
+            }
+            "savetree" => {
+                if let Some(path) = commands.get(1) {
+                    match tree.save(path) {
+                        Ok(()) => println!("info string saved tree to {path}"),
+                        Err(e) => println!("info string failed to save tree: {e}"),
+                    }
+                }
             }
-            "perft" => run_perft(&commands, &pos),
+            "loadtree" => {
+                if let Some(path) = commands.get(1) {
+                    match Tree::load(path, threads) {
+                        Ok(loaded) => {
+                            tree = loaded;
+                            pos = tree.root_position().clone();
+                            println!("info string loaded tree from {path}");
+                        }
+                        Err(e) => println!("info string failed to load tree: {e}"),
+                    }
+                }
+            }
+            #[cfg(feature = "stats")]
+            "stats" => crate::tree::contention::report(),
             "quit" => std::process::exit(0),
             "eval" => {
                 let breakdown = pos.eval_with_contempt(value, &params, pos.stm());
@@ -162,67 +209,68 @@ pub fn run(policy: &PolicyNetwork, value: &ValueNetwork, tcec_mode: bool) {
     }
 }
 
+/// Positions shared by the bench command and the kernel benchmark target.
+pub const BENCH_FENS: [&str; 54] = [
+    "r3k2r/2pb1ppp/2pp1q2/p7/1nP1B3/1P2P3/P2N1PPP/R2QK2R w KQkq a6 0 14",
+    "4rrk1/2p1b1p1/p1p3q1/4p3/2P2n1p/1P1NR2P/PB3PP1/3R1QK1 b - - 2 24",
+    "r3qbrk/6p1/2b2pPp/p3pP1Q/PpPpP2P/3P1B2/2PB3K/R5R1 w - - 16 42",
+    "6k1/1R3p2/6p1/2Bp3p/3P2q1/P7/1P2rQ1K/5R2 b - - 4 44",
+    "8/8/1p2k1p1/3p3p/1p1P1P1P/1P2PK2/8/8 w - - 3 54",
+    "7r/2p3k1/1p1p1qp1/1P1Bp3/p1P2r1P/P7/4R3/Q4RK1 w - - 0 36",
+    "r1bq1rk1/pp2b1pp/n1pp1n2/3P1p2/2P1p3/2N1P2N/PP2BPPP/R1BQ1RK1 b - - 2 10",
+    "3r3k/2r4p/1p1b3q/p4P2/P2Pp3/1B2P3/3BQ1RP/6K1 w - - 3 87",
+    "2r4r/1p4k1/1Pnp4/3Qb1pq/8/4BpPp/5P2/2RR1BK1 w - - 0 42",
+    "4q1bk/6b1/7p/p1p4p/PNPpP2P/KN4P1/3Q4/4R3 b - - 0 37",
+    "2q3r1/1r2pk2/pp3pp1/2pP3p/P1Pb1BbP/1P4Q1/R3NPP1/4R1K1 w - - 2 34",
+    "1r2r2k/1b4q1/pp5p/2pPp1p1/P3Pn2/1P1B1Q1P/2R3P1/4BR1K b - - 1 37",
+    "r3kbbr/pp1n1p1P/3ppnp1/q5N1/1P1pP3/P1N1B3/2P1QP2/R3KB1R b KQkq b3 0 17",
+    "8/6pk/2b1Rp2/3r4/1R1B2PP/P5K1/8/2r5 b - - 16 42",
+    "1r4k1/4ppb1/2n1b1qp/pB4p1/1n1BP1P1/7P/2PNQPK1/3RN3 w - - 8 29",
+    "8/p2B4/PkP5/4p1pK/4Pb1p/5P2/8/8 w - - 29 68",
+    "3r4/ppq1ppkp/4bnp1/2pN4/2P1P3/1P4P1/PQ3PBP/R4K2 b - - 2 20",
+    "5rr1/4n2k/4q2P/P1P2n2/3B1p2/4pP2/2N1P3/1RR1K2Q w - - 1 49",
+    "1r5k/2pq2p1/3p3p/p1pP4/4QP2/PP1R3P/6PK/8 w - - 1 51",
+    "q5k1/5ppp/1r3bn1/1B6/P1N2P2/BQ2P1P1/5K1P/8 b - - 2 34",
+    "r1b2k1r/5n2/p4q2/1ppn1Pp1/3pp1p1/NP2P3/P1PPBK2/1RQN2R1 w - - 0 22",
+    "r1bqk2r/pppp1ppp/5n2/4b3/4P3/P1N5/1PP2PPP/R1BQKB1R w KQkq - 0 5",
+    "r1bqr1k1/pp1p1ppp/2p5/8/3N1Q2/P2BB3/1PP2PPP/R3K2n b Q - 1 12",
+    "r1bq2k1/p4r1p/1pp2pp1/3p4/1P1B3Q/P2B1N2/2P3PP/4R1K1 b - - 2 19",
+    "r4qk1/6r1/1p4p1/2ppBbN1/1p5Q/P7/2P3PP/5RK1 w - - 2 25",
+    "r7/6k1/1p6/2pp1p2/7Q/8/p1P2K1P/8 w - - 0 32",
+    "r3k2r/ppp1pp1p/2nqb1pn/3p4/4P3/2PP4/PP1NBPPP/R2QK1NR w KQkq - 1 5",
+    "3r1rk1/1pp1pn1p/p1n1q1p1/3p4/Q3P3/2P5/PP1NBPPP/4RRK1 w - - 0 12",
+    "5rk1/1pp1pn1p/p3Brp1/8/1n6/5N2/PP3PPP/2R2RK1 w - - 2 20",
+    "8/1p2pk1p/p1p1r1p1/3n4/8/5R2/PP3PPP/4R1K1 b - - 3 27",
+    "8/4pk2/1p1r2p1/p1p4p/Pn5P/3R4/1P3PP1/4RK2 w - - 1 33",
+    "8/5k2/1pnrp1p1/p1p4p/P6P/4R1PK/1P3P2/4R3 b - - 1 38",
+    "8/8/1p1kp1p1/p1pr1n1p/P6P/1R4P1/1P3PK1/1R6 b - - 15 45",
+    "8/8/1p1k2p1/p1prp2p/P2n3P/6P1/1P1R1PK1/4R3 b - - 5 49",
+    "8/8/1p4p1/p1p2k1p/P2npP1P/4K1P1/1P6/3R4 w - - 6 54",
+    "8/8/1p4p1/p1p2k1p/P2n1P1P/4K1P1/1P6/6R1 b - - 6 59",
+    "8/5k2/1p4p1/p1pK3p/P2n1P1P/6P1/1P6/4R3 b - - 14 63",
+    "8/1R6/1p1K1kp1/p6p/P1p2P1P/6P1/1Pn5/8 w - - 0 67",
+    "1rb1rn1k/p3q1bp/2p3p1/2p1p3/2P1P2N/PP1RQNP1/1B3P2/4R1K1 b - - 4 23",
+    "4rrk1/pp1n1pp1/q5p1/P1pP4/2n3P1/7P/1P3PB1/R1BQ1RK1 w - - 3 22",
+    "r2qr1k1/pb1nbppp/1pn1p3/2ppP3/3P4/2PB1NN1/PP3PPP/R1BQR1K1 w - - 4 12",
+    "2r2k2/8/4P1R1/1p6/8/P4K1N/7b/2B5 b - - 0 55",
+    "6k1/5pp1/8/2bKP2P/2P5/p4PNb/B7/8 b - - 1 44",
+    "2rqr1k1/1p3p1p/p2p2p1/P1nPb3/2B1P3/5P2/1PQ2NPP/R1R4K w - - 3 25",
+    "r1b2rk1/p1q1ppbp/6p1/2Q5/8/4BP2/PPP3PP/2KR1B1R b - - 2 14",
+    "6r1/5k2/p1b1r2p/1pB1p1p1/1Pp3PP/2P1R1K1/2P2P2/3R4 w - - 1 36",
+    "rnbqkb1r/pppppppp/5n2/8/2PP4/8/PP2PPPP/RNBQKBNR b KQkq c3 0 2",
+    "2rr2k1/1p4bp/p1q1p1p1/4Pp1n/2PB4/1PN3P1/P3Q2P/2RR2K1 w - f6 0 20",
+    "3br1k1/p1pn3p/1p3n2/5pNq/2P1p3/1PN3PP/P2Q1PB1/4R1K1 w - - 0 23",
+    "2r2b2/5p2/5k2/p1r1pP2/P2pB3/1P3P2/K1P3R1/7R w - - 23 93",
+    "5k2/4q1p1/3P1pQb/1p1B4/pP5p/P1PR4/5PP1/1K6 b - - 0 38",
+    "5rk1/1rP3pp/p4n2/3Pp3/1P2Pq2/2Q4P/P5P1/R3R1K1 b - - 0 32",
+    "4r1k1/4r1p1/8/p2R1P1K/5P1P/1QP3q1/1P6/3R4 b - - 0 1",
+    "3qk1b1/1p4r1/1n4r1/2P1b2B/p3N2p/P2Q3P/8/1R3R1K w - - 2 39",
+];
+
 pub fn bench(depth: usize, policy: &PolicyNetwork, value: &ValueNetwork, params: &MctsParams) {
     let mut total_nodes = 0;
     let mut time = 0.0;
 
-    let bench_fens = [
-        "r3k2r/2pb1ppp/2pp1q2/p7/1nP1B3/1P2P3/P2N1PPP/R2QK2R w KQkq a6 0 14",
-        "4rrk1/2p1b1p1/p1p3q1/4p3/2P2n1p/1P1NR2P/PB3PP1/3R1QK1 b - - 2 24",
-        "r3qbrk/6p1/2b2pPp/p3pP1Q/PpPpP2P/3P1B2/2PB3K/R5R1 w - - 16 42",
-        "6k1/1R3p2/6p1/2Bp3p/3P2q1/P7/1P2rQ1K/5R2 b - - 4 44",
-        "8/8/1p2k1p1/3p3p/1p1P1P1P/1P2PK2/8/8 w - - 3 54",
-        "7r/2p3k1/1p1p1qp1/1P1Bp3/p1P2r1P/P7/4R3/Q4RK1 w - - 0 36",
-        "r1bq1rk1/pp2b1pp/n1pp1n2/3P1p2/2P1p3/2N1P2N/PP2BPPP/R1BQ1RK1 b - - 2 10",
-        "3r3k/2r4p/1p1b3q/p4P2/P2Pp3/1B2P3/3BQ1RP/6K1 w - - 3 87",
-        "2r4r/1p4k1/1Pnp4/3Qb1pq/8/4BpPp/5P2/2RR1BK1 w - - 0 42",
-        "4q1bk/6b1/7p/p1p4p/PNPpP2P/KN4P1/3Q4/4R3 b - - 0 37",
-        "2q3r1/1r2pk2/pp3pp1/2pP3p/P1Pb1BbP/1P4Q1/R3NPP1/4R1K1 w - - 2 34",
-        "1r2r2k/1b4q1/pp5p/2pPp1p1/P3Pn2/1P1B1Q1P/2R3P1/4BR1K b - - 1 37",
-        "r3kbbr/pp1n1p1P/3ppnp1/q5N1/1P1pP3/P1N1B3/2P1QP2/R3KB1R b KQkq b3 0 17",
-        "8/6pk/2b1Rp2/3r4/1R1B2PP/P5K1/8/2r5 b - - 16 42",
-        "1r4k1/4ppb1/2n1b1qp/pB4p1/1n1BP1P1/7P/2PNQPK1/3RN3 w - - 8 29",
-        "8/p2B4/PkP5/4p1pK/4Pb1p/5P2/8/8 w - - 29 68",
-        "3r4/ppq1ppkp/4bnp1/2pN4/2P1P3/1P4P1/PQ3PBP/R4K2 b - - 2 20",
-        "5rr1/4n2k/4q2P/P1P2n2/3B1p2/4pP2/2N1P3/1RR1K2Q w - - 1 49",
-        "1r5k/2pq2p1/3p3p/p1pP4/4QP2/PP1R3P/6PK/8 w - - 1 51",
-        "q5k1/5ppp/1r3bn1/1B6/P1N2P2/BQ2P1P1/5K1P/8 b - - 2 34",
-        "r1b2k1r/5n2/p4q2/1ppn1Pp1/3pp1p1/NP2P3/P1PPBK2/1RQN2R1 w - - 0 22",
-        "r1bqk2r/pppp1ppp/5n2/4b3/4P3/P1N5/1PP2PPP/R1BQKB1R w KQkq - 0 5",
-        "r1bqr1k1/pp1p1ppp/2p5/8/3N1Q2/P2BB3/1PP2PPP/R3K2n b Q - 1 12",
-        "r1bq2k1/p4r1p/1pp2pp1/3p4/1P1B3Q/P2B1N2/2P3PP/4R1K1 b - - 2 19",
-        "r4qk1/6r1/1p4p1/2ppBbN1/1p5Q/P7/2P3PP/5RK1 w - - 2 25",
-        "r7/6k1/1p6/2pp1p2/7Q/8/p1P2K1P/8 w - - 0 32",
-        "r3k2r/ppp1pp1p/2nqb1pn/3p4/4P3/2PP4/PP1NBPPP/R2QK1NR w KQkq - 1 5",
-        "3r1rk1/1pp1pn1p/p1n1q1p1/3p4/Q3P3/2P5/PP1NBPPP/4RRK1 w - - 0 12",
-        "5rk1/1pp1pn1p/p3Brp1/8/1n6/5N2/PP3PPP/2R2RK1 w - - 2 20",
-        "8/1p2pk1p/p1p1r1p1/3n4/8/5R2/PP3PPP/4R1K1 b - - 3 27",
-        "8/4pk2/1p1r2p1/p1p4p/Pn5P/3R4/1P3PP1/4RK2 w - - 1 33",
-        "8/5k2/1pnrp1p1/p1p4p/P6P/4R1PK/1P3P2/4R3 b - - 1 38",
-        "8/8/1p1kp1p1/p1pr1n1p/P6P/1R4P1/1P3PK1/1R6 b - - 15 45",
-        "8/8/1p1k2p1/p1prp2p/P2n3P/6P1/1P1R1PK1/4R3 b - - 5 49",
-        "8/8/1p4p1/p1p2k1p/P2npP1P/4K1P1/1P6/3R4 w - - 6 54",
-        "8/8/1p4p1/p1p2k1p/P2n1P1P/4K1P1/1P6/6R1 b - - 6 59",
-        "8/5k2/1p4p1/p1pK3p/P2n1P1P/6P1/1P6/4R3 b - - 14 63",
-        "8/1R6/1p1K1kp1/p6p/P1p2P1P/6P1/1Pn5/8 w - - 0 67",
-        "1rb1rn1k/p3q1bp/2p3p1/2p1p3/2P1P2N/PP1RQNP1/1B3P2/4R1K1 b - - 4 23",
-        "4rrk1/pp1n1pp1/q5p1/P1pP4/2n3P1/7P/1P3PB1/R1BQ1RK1 w - - 3 22",
-        "r2qr1k1/pb1nbppp/1pn1p3/2ppP3/3P4/2PB1NN1/PP3PPP/R1BQR1K1 w - - 4 12",
-        "2r2k2/8/4P1R1/1p6/8/P4K1N/7b/2B5 b - - 0 55",
-        "6k1/5pp1/8/2bKP2P/2P5/p4PNb/B7/8 b - - 1 44",
-        "2rqr1k1/1p3p1p/p2p2p1/P1nPb3/2B1P3/5P2/1PQ2NPP/R1R4K w - - 3 25",
-        "r1b2rk1/p1q1ppbp/6p1/2Q5/8/4BP2/PPP3PP/2KR1B1R b - - 2 14",
-        "6r1/5k2/p1b1r2p/1pB1p1p1/1Pp3PP/2P1R1K1/2P2P2/3R4 w - - 1 36",
-        "rnbqkb1r/pppppppp/5n2/8/2PP4/8/PP2PPPP/RNBQKBNR b KQkq c3 0 2",
-        "2rr2k1/1p4bp/p1q1p1p1/4Pp1n/2PB4/1PN3P1/P3Q2P/2RR2K1 w - f6 0 20",
-        "3br1k1/p1pn3p/1p3n2/5pNq/2P1p3/1PN3PP/P2Q1PB1/4R1K1 w - - 0 23",
-        "2r2b2/5p2/5k2/p1r1pP2/P2pB3/1P3P2/K1P3R1/7R w - - 23 93",
-        "5k2/4q1p1/3P1pQb/1p1B4/pP5p/P1PR4/5PP1/1K6 b - - 0 38",
-        "5rk1/1rP3pp/p4n2/3Pp3/1P2Pq2/2Q4P/P5P1/R3R1K1 b - - 0 32",
-        "4r1k1/4r1p1/8/p2R1P1K/5P1P/1QP3q1/1P6/3R4 b - - 0 1",
-        "3qk1b1/1p4r1/1n4r1/2P1b2B/p3N2p/P2Q3P/8/1R3R1K w - - 2 39",
-    ];
-
     let limits = Limits {
         max_time: None,
         opt_time: None,
@@ -234,7 +282,7 @@ pub fn bench(depth: usize, policy: &PolicyNetwork, value: &ValueNetwork, params:
 
     let mut tree = Tree::new_mb(32, 1);
 
-    for fen in bench_fens {
+    for fen in BENCH_FENS {
         let abort = AtomicBool::new(false);
         let pos = ChessState::from_fen(fen);
         tree.set_root_position(&pos);
@@ -254,15 +302,151 @@ pub fn bench(depth: usize, policy: &PolicyNetwork, value: &ValueNetwork, params:
     );
 }
 
+/// Mean and 95% confidence interval over per-repetition throughputs.
+fn bench_stats(samples: &[f64]) -> (f64, f64) {
+    let n = samples.len() as f64;
+    let mean = samples.iter().sum::<f64>() / n;
+    let var = samples.iter().map(|s| (s - mean) * (s - mean)).sum::<f64>() / n;
+    (mean, 1.96 * (var / n).sqrt())
+}
+
+fn bench_report(name: &str, unit: &str, samples: &[f64], reps: usize, json: bool) {
+    let (mean, ci) = bench_stats(samples);
+
+    if json {
+        println!(
+            "{{\"bench\":\"{name}\",\"unit\":\"{unit}\",\"mean\":{mean:.1},\"ci95\":{ci:.1},\"reps\":{reps}}}"
+        );
+    } else {
+        println!("{name}: {mean:.0} +/- {ci:.0} {unit} ({reps} reps)");
+    }
+}
+
+/// Component-level benchmarks: each sub-benchmark does one warmup pass then
+/// timed repetitions, reporting mean throughput with a confidence interval.
+/// `bench suite json` emits one JSON object per line for CI diffing.
+fn bench_suite(
+    commands: &[&str],
+    policy: &PolicyNetwork,
+    value: &ValueNetwork,
+    params: &MctsParams,
+) {
+    const REPS: usize = 10;
+
+    let which = commands[1];
+    let json = commands.contains(&"json");
+
+    let positions: Vec<ChessState> = BENCH_FENS.iter().map(|f| ChessState::from_fen(f)).collect();
+
+    if matches!(which, "suite" | "value") {
+        let mut samples = Vec::with_capacity(REPS);
+
+        for rep in 0..=REPS {
+            let timer = Instant::now();
+            let mut sink = 0.0;
+
+            for pos in &positions {
+                sink += pos.raw_eval(value).0;
+            }
+
+            // discard the warmup repetition
+            if rep > 0 {
+                samples.push(positions.len() as f64 / timer.elapsed().as_secs_f64());
+            }
+
+            std::hint::black_box(sink);
+        }
+
+        bench_report("value_eval", "evals/s", &samples, REPS, json);
+    }
+
+    if matches!(which, "suite" | "policy") {
+        let mut samples = Vec::with_capacity(REPS);
+
+        for rep in 0..=REPS {
+            let timer = Instant::now();
+            let mut sink = 0.0;
+            let mut moves = 0usize;
+
+            for pos in &positions {
+                pos.map_moves_with_policies(policy, |_, p| {
+                    sink += p;
+                    moves += 1;
+                });
+            }
+
+            if rep > 0 {
+                samples.push(moves as f64 / timer.elapsed().as_secs_f64());
+            }
+
+            std::hint::black_box(sink);
+        }
+
+        bench_report("policy_expand", "moves/s", &samples, REPS, json);
+    }
+
+    if matches!(which, "suite" | "tree") {
+        const OPS: usize = 200_000;
+
+        // synthetic single-node tree: expanded root, then repeated
+        // selection sweeps and stat backups against its children
+        let mut tree = Tree::new_mb(32, 1);
+        tree.set_root_position(&ChessState::default());
+
+        let abort = AtomicBool::new(false);
+        let searcher = Searcher::new(&tree, params, policy, value, &abort);
+        let limits = Limits {
+            max_time: None,
+            opt_time: None,
+            max_depth: 256,
+            max_nodes: 1,
+            #[cfg(feature = "datagen")]
+            kld_min_gain: None,
+        };
+        #[cfg(not(feature = "datagen"))]
+        searcher.search(1, limits, false, 1, false, &mut 0);
+        #[cfg(feature = "datagen")]
+        searcher.search(1, limits, false, 1, false, &mut 0, false, 1.0);
+
+        let root = tree.root_node();
+        let mut samples = Vec::with_capacity(REPS);
+
+        for rep in 0..=REPS {
+            let timer = Instant::now();
+            let mut sink = 0usize;
+
+            for i in 0..OPS {
+                sink += tree.get_best_child(root);
+                tree.update_node_stats(root, (i & 1) as f32, 0.0, 0);
+            }
+
+            if rep > 0 {
+                samples.push(OPS as f64 / timer.elapsed().as_secs_f64());
+            }
+
+            std::hint::black_box(sink);
+        }
+
+        bench_report("tree_select_backup", "ops/s", &samples, REPS, json);
+    }
+
+    if which == "suite" {
+        bench(ChessState::BENCH_DEPTH, policy, value, params);
+    }
+}
+
 fn preamble(tcec_mode: bool) {
     println!("id name {}", env!("FORMATTED_NAME"));
     println!("id author Jamie Whiting, Viren & The Monty Authors");
     println!("option name Hash type spin default 64 min 1 max 524288");
+    println!("option name EvalCache type spin default 16 min 1 max 65536");
+    println!("option name HugePages type check default true");
     println!("option name Threads type spin default 1 min 1 max 512");
     println!("option name UCI_Chess960 type check default false");
     println!("option name Contempt_Analysis type check default false");
     println!("option name MoveOverhead type spin default 400 min 0 max 5000");
     println!("option name MultiPV type spin default 1 min 1 max 10");
+    println!("option name Ponder type check default false");
     println!("option name GUI_Compatibility type check default true");
     println!("option name report_moves type button");
     println!("option name report_iters type button");
@@ -287,6 +471,7 @@ fn setoption(
     threads: &mut usize,
     move_overhead: &mut usize,
     hash_mb: &mut usize,
+    eval_cache_mb: &mut usize,
     multipv: &mut usize,
     gui_compatibility: &mut bool,
     uci_opponent_rating: &mut Option<i32>,
@@ -306,6 +491,7 @@ fn setoption(
             REPORT_ITERS.fetch_xor(true, Ordering::Relaxed);
         }
         "UCI_Chess960" => {}
+        "Ponder" => {}
         "Contempt_Analysis" => {
             if let Some(v) = value {
                 *disable_tree_reuse = v.eq_ignore_ascii_case("true");
@@ -317,6 +503,7 @@ fn setoption(
                     *threads = parsed.max(1);
                     let root = tree.root_position().clone();
                     tree.rebuild(*hash_mb, *threads, root);
+                    tree.resize_eval_cache(*eval_cache_mb);
                 }
             }
         }
@@ -333,6 +520,23 @@ fn setoption(
                     *hash_mb = parsed.max(1) as usize;
                     let root = tree.root_position().clone();
                     tree.rebuild(*hash_mb, *threads, root);
+                    tree.resize_eval_cache(*eval_cache_mb);
+                }
+            }
+        }
+        "HugePages" => {
+            if let Some(v) = value {
+                HUGE_PAGES.store(v.eq_ignore_ascii_case("true"), Ordering::Relaxed);
+                let root = tree.root_position().clone();
+                tree.rebuild(*hash_mb, *threads, root);
+                tree.resize_eval_cache(*eval_cache_mb);
+            }
+        }
+        "EvalCache" => {
+            if let Some(v) = value {
+                if let Ok(parsed) = v.parse::<i32>() {
+                    *eval_cache_mb = parsed.max(1) as usize;
+                    tree.resize_eval_cache(*eval_cache_mb);
                 }
             }
         }
@@ -510,6 +714,7 @@ fn go(
     let mut max_nodes = usize::MAX;
     let mut max_time = None;
     let mut max_depth = 256;
+    let mut ponder = false;
 
     let mut times = [None; 2];
     let mut incs = [None; 2];
@@ -522,6 +727,7 @@ fn go(
 
     for cmd in commands {
         match *cmd {
+            "ponder" => ponder = true,
             "nodes" => mode = "nodes",
             "movetime" => mode = "movetime",
             "depth" => mode = "depth",
@@ -562,7 +768,11 @@ fn go(
         max_time = Some(max_time.unwrap_or(u128::MAX).min(max));
     }
 
-    let abort = AtomicBool::new(false);
+    #[cfg(feature = "stats")]
+    crate::tree::contention::reset();
+
+    #[cfg(feature = "profile")]
+    crate::mcts::profile::reset();
 
     if disable_tree_reuse {
         tree.clear(threads);
@@ -570,48 +780,188 @@ fn go(
 
     tree.set_root_position(pos);
 
+    // `go ponder` searches without limits until a ponderhit converts it to
+    // a normal timed search over the already-grown tree, or a stop makes us
+    // report the deferred best move
+    let mut pondering = ponder;
+
+    loop {
+        let abort = AtomicBool::new(false);
+        let ponderhit = AtomicBool::new(false);
+
+        let limits = if pondering {
+            Limits {
+                max_time: None,
+                opt_time: None,
+                max_depth: 256,
+                max_nodes: usize::MAX,
+                #[cfg(feature = "datagen")]
+                kld_min_gain: None,
+            }
+        } else {
+            Limits {
+                max_time,
+                opt_time,
+                max_depth,
+                max_nodes,
+                #[cfg(feature = "datagen")]
+                kld_min_gain: None,
+            }
+        };
+
+        let mut deferred = None;
+
+        std::thread::scope(|s| {
+            let search_thread = s.spawn(|| {
+                let searcher = Searcher::new(tree, params, policy, value, &abort);
+                let mov = searcher
+                    .search(
+                        threads,
+                        limits,
+                        true,
+                        multipv,
+                        gui_compatibility,
+                        &mut 0,
+                        #[cfg(feature = "datagen")]
+                        false,
+                        #[cfg(feature = "datagen")]
+                        temp,
+                    )
+                    .0;
+
+                if pondering {
+                    // converted or stopped: the caller decides whether this
+                    // best move is reported or superseded by the real search
+                    Some(pos.conv_mov_to_str(mov))
+                } else {
+                    println!("bestmove {}", pos.conv_mov_to_str(mov));
+
+                    if report_moves {
+                        searcher.display_moves();
+                    }
+
+                    None
+                }
+            });
+
+            *stored_message = handle_search_input(&abort, pondering, &ponderhit);
+
+            deferred = search_thread.join().unwrap();
+        });
+
+        if pondering && ponderhit.load(Ordering::Relaxed) {
+            // ponderhit: the grown tree is reused in full by the timed
+            // search via the subtree-reuse path (same root position)
+            pondering = false;
+            continue;
+        }
+
+        if let Some(best) = deferred {
+            println!("bestmove {best}");
+        }
+
+        break;
+    }
+
+    #[cfg(feature = "profile")]
+    crate::mcts::profile::report();
+}
+
+/// Bulk-labelling mode: read one FEN per line (from a file, or stdin until
+/// an "end" line or EOF), search each with a fixed node budget while the
+/// tree, hash table and mapped networks stay alive across positions, and
+/// emit one CSV line per position. The tree is cleared between positions
+/// rather than reallocated, so per-position overhead is the search alone.
+fn batchanalyse(
+    commands: &[&str],
+    tree: &mut Tree,
+    params: &MctsParams,
+    policy: &PolicyNetwork,
+    value: &ValueNetwork,
+    threads: usize,
+) {
+    use std::io::BufRead;
+
+    let nodes = commands
+        .get(1)
+        .and_then(|n| n.parse().ok())
+        .unwrap_or(10_000);
+
+    let reader: Box<dyn BufRead> = if let Some(path) = commands.get(2) {
+        match std::fs::File::open(path) {
+            Ok(file) => Box::new(std::io::BufReader::new(file)),
+            Err(e) => {
+                println!("info string failed to open {path}: {e}");
+                return;
+            }
+        }
+    } else {
+        Box::new(std::io::BufReader::new(io::stdin()))
+    };
+
     let limits = Limits {
-        max_time,
-        opt_time,
-        max_depth,
-        max_nodes,
+        max_time: None,
+        opt_time: None,
+        max_depth: 256,
+        max_nodes: nodes,
         #[cfg(feature = "datagen")]
         kld_min_gain: None,
     };
 
-    std::thread::scope(|s| {
-        s.spawn(|| {
-            let searcher = Searcher::new(tree, params, policy, value, &abort);
-            let mov = searcher
-                .search(
-                    threads,
-                    limits,
-                    true,
-                    multipv,
-                    gui_compatibility,
-                    &mut 0,
-                    #[cfg(feature = "datagen")]
-                    false,
-                    #[cfg(feature = "datagen")]
-                    temp,
-                )
-                .0;
-            println!("bestmove {}", pos.conv_mov_to_str(mov));
+    println!("fen,bestmove,q,cp,nodes");
 
-            if report_moves {
-                searcher.display_moves();
-            }
-        });
+    for line in reader.lines() {
+        let Ok(line) = line else { break };
+        let fen = line.trim();
 
-        *stored_message = handle_search_input(&abort);
-    });
+        if fen.is_empty() || fen == "end" {
+            break;
+        }
+
+        let pos = ChessState::from_fen(fen);
+
+        // bulk inputs are guaranteed to contain mates, stalemates and
+        // rule-draws; searching a terminal root is meaningless (and a
+        // mated root has no legal move to report), so emit the terminal
+        // verdict directly with a null best move
+        let state = pos.game_state();
+        if state != crate::chess::GameState::Ongoing {
+            let q: f32 = match state {
+                crate::chess::GameState::Lost(_) => 0.0,
+                crate::chess::GameState::Won(_) => 1.0,
+                _ => 0.5,
+            };
+
+            let cp = (-400.0 * (1.0 / q.clamp(0.001, 0.999) - 1.0).ln()).round() as i32;
+            println!("{fen},0000,{q:.4},{cp},0");
+            continue;
+        }
+
+        tree.clear(threads);
+        tree.set_root_position(&pos);
+
+        let abort = AtomicBool::new(false);
+        let searcher = Searcher::new(tree, params, policy, value, &abort);
+
+        let mut searched = 0;
+        #[cfg(not(feature = "datagen"))]
+        let (mov, q) = searcher.search(threads, limits, false, 1, false, &mut searched);
+        #[cfg(feature = "datagen")]
+        let (mov, q, _) =
+            searcher.search(threads, limits, false, 1, false, &mut searched, false, 1.0);
+
+        let q = q.clamp(0.001, 0.999);
+        let cp = (-400.0 * (1.0 / q - 1.0).ln()).round() as i32;
+
+        println!("{fen},{},{q:.4},{cp},{searched}", pos.conv_mov_to_str(mov));
+    }
 }
 
-fn run_perft(commands: &[&str], pos: &ChessState) {
+fn run_perft(commands: &[&str], pos: &ChessState, threads: usize, hash_mb: usize) {
     let depth = commands[1].parse().unwrap();
     let root_pos = pos.clone();
     let now = Instant::now();
-    let count = root_pos.perft(depth);
+    let count = root_pos.perft_parallel(depth, threads, hash_mb);
     let time = now.elapsed().as_micros();
     println!(
         "perft {depth} time {} nodes {count} ({:.2} Mnps)",
@@ -620,7 +970,7 @@ fn run_perft(commands: &[&str], pos: &ChessState) {
     );
 }
 
-fn handle_search_input(abort: &AtomicBool) -> Option<String> {
+fn handle_search_input(abort: &AtomicBool, pondering: bool, ponderhit: &AtomicBool) -> Option<String> {
     loop {
         let mut input = String::new();
         let bytes_read = io::stdin().read_line(&mut input).unwrap();
@@ -636,6 +986,13 @@ fn handle_search_input(abort: &AtomicBool) -> Option<String> {
                 abort.store(true, Ordering::Relaxed);
                 return None;
             }
+            "ponderhit" => {
+                if pondering {
+                    ponderhit.store(true, Ordering::Relaxed);
+                    abort.store(true, Ordering::Relaxed);
+                    return None;
+                }
+            }
             _ => return Some(input),
         };
     }